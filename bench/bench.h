@@ -0,0 +1,67 @@
+
+//                   Copyright(c) Kamil Kaznowski 2021.
+//         Distributed under the Boost Software License, Version 1.0.
+//                (See accompanying file LICENSE or copy at
+//                  https://www.boost.org/LICENSE_1_0.txt)
+
+// Minimal microbenchmark harness for imath.
+// Each benchmark is a function running its body `iterations` times,
+// the harness scales the number of iterations until the measurement
+// is long enough, and reports the time per single iteration.
+
+#ifndef IMATHLIB_BENCH_BENCH_H
+#define IMATHLIB_BENCH_BENCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace bench {
+
+using BenchmarkFunction = void (*)(size_t iterations);
+
+struct Benchmark {
+    const char* name;
+    BenchmarkFunction function;
+};
+
+inline std::vector<Benchmark>& registry() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+struct Registrar {
+    Registrar(const char* name, BenchmarkFunction function) {
+        registry().push_back({name, function});
+    }
+};
+
+/**
+ * Seed of all the input generators, set with --seed=N for other inputs.
+ * Inputs are generated on first use, after the command line is parsed.
+ * */
+inline uint64_t& seed() {
+    static uint64_t value = 2021;
+    return value;
+}
+
+/**
+ * Prevents the compiler from optimizing away the computation of value.
+ * */
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUG__) || defined(__clang__)
+    __asm__ volatile("" : : "r,m"(value) : "memory");
+#else
+    static_cast<void>(*static_cast<const volatile T*>(&value));
+#endif
+}
+
+}  // namespace bench
+
+#define IMATHLIB_BENCHMARK(name)                                   \
+    static void name(size_t iterations);                           \
+    static const bench::Registrar name##_registrar{#name, name};   \
+    static void name(size_t iterations)
+
+#endif  // IMATHLIB_BENCH_BENCH_H
@@ -0,0 +1,76 @@
+
+//                   Copyright(c) Kamil Kaznowski 2021.
+//         Distributed under the Boost Software License, Version 1.0.
+//                (See accompanying file LICENSE or copy at
+//                  https://www.boost.org/LICENSE_1_0.txt)
+
+// Leading and trailing zero counts, the intrinsics and their fallbacks.
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "imath.h"
+#include "bench.h"
+
+using u32 = uint32_t;
+using u64 = uint64_t;
+
+namespace {
+
+constexpr size_t kInputs = 1024;
+
+// Non-zero numbers with uniformly distributed bit lengths
+// and numbers of trailing zeroes
+const std::vector<u64>& bitInputs() {
+    static const std::vector<u64> inputs = [] {
+        std::mt19937_64 rng{bench::seed()};
+        std::vector<u64> result(kInputs);
+        for (u64& n : result) {
+            n = ((rng() | 1) << (rng() % 64)) >> (rng() % 64);
+            n |= n == 0;
+        }
+        return result;
+    }();
+    return inputs;
+}
+
+template <typename T, typename Function>
+void countZeroes(size_t iterations, Function function) {
+    const auto& inputs = bitInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        T n = static_cast<T>(inputs[i % kInputs]);
+        bench::doNotOptimize(function(n | (n == 0)));
+    }
+}
+
+}  // namespace
+
+IMATHLIB_BENCHMARK(clz_u32) {
+    countZeroes<u32>(iterations, [](u32 n) { return imath::detail::clz(n); });
+}
+IMATHLIB_BENCHMARK(clz_u32_fallback) {
+    countZeroes<u32>(iterations,
+                     [](u32 n) { return imath::detail::clzFallback(n); });
+}
+IMATHLIB_BENCHMARK(clz_u64) {
+    countZeroes<u64>(iterations, [](u64 n) { return imath::detail::clz(n); });
+}
+IMATHLIB_BENCHMARK(clz_u64_fallback) {
+    countZeroes<u64>(iterations,
+                     [](u64 n) { return imath::detail::clzFallback(n); });
+}
+IMATHLIB_BENCHMARK(ctz_u32) {
+    countZeroes<u32>(iterations, [](u32 n) { return imath::detail::ctz(n); });
+}
+IMATHLIB_BENCHMARK(ctz_u32_fallback) {
+    countZeroes<u32>(iterations,
+                     [](u32 n) { return imath::detail::ctzFallback(n); });
+}
+IMATHLIB_BENCHMARK(ctz_u64) {
+    countZeroes<u64>(iterations, [](u64 n) { return imath::detail::ctz(n); });
+}
+IMATHLIB_BENCHMARK(ctz_u64_fallback) {
+    countZeroes<u64>(iterations,
+                     [](u64 n) { return imath::detail::ctzFallback(n); });
+}
@@ -0,0 +1,103 @@
+
+//                   Copyright(c) Kamil Kaznowski 2021.
+//         Distributed under the Boost Software License, Version 1.0.
+//                (See accompanying file LICENSE or copy at
+//                  https://www.boost.org/LICENSE_1_0.txt)
+
+// Division and rounding by a runtime-invariant divisor,
+// with the hardware division and with precomputed Divider.
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "imath.h"
+#include "bench.h"
+
+using u32 = uint32_t;
+using u64 = uint64_t;
+
+namespace {
+
+constexpr size_t kInputs = 1024;
+
+template <typename T>
+struct DividerInput {
+    std::vector<T> numbers;
+    T divisor;
+};
+
+// Divisors unknown at compile time, one needing the 33 bit magic number
+template <typename T>
+const DividerInput<T>& dividerInput() {
+    static const DividerInput<T> input = [] {
+        std::mt19937_64 rng{bench::seed()};
+        DividerInput<T> result{std::vector<T>(kInputs), 0};
+        result.divisor = static_cast<T>(7 + rng() % 2 * 2);  // 7 or 9
+        for (T& number : result.numbers) {
+            number = static_cast<T>(rng() >> 1);
+        }
+        return result;
+    }();
+    return input;
+}
+
+template <typename T>
+void roundUpHardware(size_t iterations) {
+    const auto& input = dividerInput<T>();
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(imath::roundUpToMultipleOf(
+            input.numbers[i % kInputs], input.divisor));
+    }
+}
+
+template <typename T, bool BRANCHFREE>
+void roundUpDivider(size_t iterations) {
+    const auto& input = dividerInput<T>();
+    const imath::Divider<T, BRANCHFREE> divider{input.divisor};
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(imath::roundUpToMultipleOf(
+            input.numbers[i % kInputs], divider));
+    }
+}
+
+}  // namespace
+
+IMATHLIB_BENCHMARK(roundUpToMultipleOf_u32) {
+    roundUpHardware<u32>(iterations);
+}
+
+IMATHLIB_BENCHMARK(roundUpToMultipleOf_u32_divider) {
+    roundUpDivider<u32, false>(iterations);
+}
+
+IMATHLIB_BENCHMARK(roundUpToMultipleOf_u32_branchfree) {
+    roundUpDivider<u32, true>(iterations);
+}
+
+IMATHLIB_BENCHMARK(roundUpToMultipleOf_u64) {
+    roundUpHardware<u64>(iterations);
+}
+
+IMATHLIB_BENCHMARK(roundUpToMultipleOf_u64_divider) {
+    roundUpDivider<u64, false>(iterations);
+}
+
+IMATHLIB_BENCHMARK(roundUpToMultipleOf_u64_branchfree) {
+    roundUpDivider<u64, true>(iterations);
+}
+
+IMATHLIB_BENCHMARK(divide_u64) {
+    const auto& input = dividerInput<u64>();
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(input.numbers[i % kInputs] / input.divisor);
+    }
+}
+
+IMATHLIB_BENCHMARK(divide_u64_divider) {
+    const auto& input = dividerInput<u64>();
+    const imath::Divider<u64> divider{input.divisor};
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(divider.divide(input.numbers[i % kInputs]));
+    }
+}
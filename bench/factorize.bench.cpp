@@ -0,0 +1,193 @@
+
+//                   Copyright(c) Kamil Kaznowski 2021.
+//         Distributed under the Boost Software License, Version 1.0.
+//                (See accompanying file LICENSE or copy at
+//                  https://www.boost.org/LICENSE_1_0.txt)
+
+// Factorization of 64-bit numbers of different shapes.
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "imath.h"
+#include "bench.h"
+#include "inputs.h"
+
+using u32 = uint32_t;
+using u64 = uint64_t;
+
+namespace {
+
+constexpr size_t kInputs = 256;
+
+// Uniformly distributed numbers, most of them have a few small factors
+// and one or two large ones
+template <typename T>
+const std::vector<T>& uniformInputs() {
+    static const std::vector<T> inputs = [] {
+        std::mt19937_64 rng{bench::seed()};
+        std::vector<T> result(kInputs);
+        for (T& n : result) {
+            n = static_cast<T>(rng());
+        }
+        return result;
+    }();
+    return inputs;
+}
+
+// Numbers below 2^16, covered by kTable
+const std::vector<u32>& tableInputs() {
+    static const std::vector<u32> inputs = [] {
+        std::mt19937_64 rng{bench::seed()};
+        std::vector<u32> result(kInputs);
+        for (u32& n : result) {
+            n = static_cast<u32>(rng() >> 48);
+        }
+        return result;
+    }();
+    return inputs;
+}
+
+constexpr imath::FactorTable<(1 << 16)> kTable{};
+
+// Products of primes below 10^4, up to 48 bits
+const std::vector<u64>& smallFactorInputs() {
+    static const std::vector<u64> inputs = [] {
+        std::mt19937_64 rng{bench::seed()};
+        std::vector<u64> result(kInputs);
+        for (u64& n : result) {
+            n = 1;
+            while (true) {
+                u64 p = imath::nextPrimeAfter(rng() % 10000);
+                if (p >= 10000 || n * p >= (u64{1} << 48)) break;
+                n *= p;
+            }
+        }
+        return result;
+    }();
+    return inputs;
+}
+
+// p^k * q with primes p, q above the trial division bound
+const std::vector<u64>& primePowerInputs() {
+    static const std::vector<u64> inputs = [] {
+        std::mt19937_64 rng{bench::seed()};
+        std::vector<u64> result(kInputs);
+        for (u64& n : result) {
+            uint32_t k = static_cast<uint32_t>(rng() % 4 + 2);
+            u64 q = imath::nextPrimeAfter(rng() % 1000 + 53);
+            u64 max_root = imath::iroot(UINT64_MAX / q, k);
+            u64 p = imath::nextPrimeAfter(rng() % (max_root / 2) + 53);
+            n = imath::pow(p, u64{k}) * q;
+        }
+        return result;
+    }();
+    return inputs;
+}
+
+// Products of two primes of similar size, the hardest case for rho
+const std::vector<u64>& semiprimeInputs() {
+    static const std::vector<u64> inputs = [] {
+        std::mt19937_64 rng{bench::seed()};
+        std::vector<u64> result(kInputs);
+        for (u64& n : result) {
+            u64 p = imath::nextPrimeAfter(rng() >> 33);
+            u64 q = imath::nextPrimeAfter(rng() >> 33);
+            n = p * q;
+        }
+        return result;
+    }();
+    return inputs;
+}
+
+template <int BITS>
+const std::vector<u64>& semiprimesWithBits() {
+    static const std::vector<u64> inputs =
+        bench::numbersOfClass(bench::NumberClass::kSemiprime, BITS, kInputs);
+    return inputs;
+}
+
+}  // namespace
+
+IMATHLIB_BENCHMARK(factorize_u32_uniform) {
+    const auto& inputs = uniformInputs<u32>();
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(imath::factorize(inputs[i % kInputs]));
+    }
+}
+
+IMATHLIB_BENCHMARK(factorize_u32_below_2_16) {
+    const auto& inputs = tableInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(imath::factorize(inputs[i % kInputs]));
+    }
+}
+
+IMATHLIB_BENCHMARK(factorize_u32_below_2_16_table) {
+    const auto& inputs = tableInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(kTable.factorize(inputs[i % kInputs]));
+    }
+}
+
+IMATHLIB_BENCHMARK(factorize_u64_uniform) {
+    const auto& inputs = uniformInputs<u64>();
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(imath::factorize(inputs[i % kInputs]));
+    }
+}
+
+IMATHLIB_BENCHMARK(factorize_u64_small_factors) {
+    const auto& inputs = smallFactorInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(imath::factorize(inputs[i % kInputs]));
+    }
+}
+
+IMATHLIB_BENCHMARK(factorize_u64_prime_powers) {
+    const auto& inputs = primePowerInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(imath::factorize(inputs[i % kInputs]));
+    }
+}
+
+IMATHLIB_BENCHMARK(factorize_u64_semiprimes) {
+    const auto& inputs = semiprimeInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(imath::factorize(inputs[i % kInputs]));
+    }
+}
+
+#if IMATHLIB_ENABLE_THREADS
+// Walks raced on all the hardware threads
+IMATHLIB_BENCHMARK(factorize_u64_semiprimes_parallel) {
+    const auto& inputs = semiprimeInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(imath::factorizeParallel(inputs[i % kInputs]));
+    }
+}
+#endif
+
+IMATHLIB_BENCHMARK(factorize_u64_semiprimes_32bit) {
+    const auto& inputs = semiprimesWithBits<32>();
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(imath::factorize(inputs[i % kInputs]));
+    }
+}
+
+IMATHLIB_BENCHMARK(factorize_u64_semiprimes_48bit) {
+    const auto& inputs = semiprimesWithBits<48>();
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(imath::factorize(inputs[i % kInputs]));
+    }
+}
+
+// The same 256 numbers over and over, all of them fit in the cache
+IMATHLIB_BENCHMARK(factorize_u64_uniform_cached) {
+    const auto& inputs = uniformInputs<u64>();
+    static imath::FactorizationCache cache{4 * kInputs};
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(cache.factorize(inputs[i % kInputs]));
+    }
+}
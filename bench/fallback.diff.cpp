@@ -0,0 +1,183 @@
+
+//                   Copyright(c) Kamil Kaznowski 2021.
+//         Distributed under the Boost Software License, Version 1.0.
+//                (See accompanying file LICENSE or copy at
+//                  https://www.boost.org/LICENSE_1_0.txt)
+
+// Intrinsic code paths against their portable fallbacks. Both variants
+// run on the same inputs, the results are compared and the speed ratio
+// is reported. Exits with 1 if any results differ.
+//
+// Usage: imath_fallback_diff [--seed=N] [filter]
+//
+// For whole functions, compare the --json output of imath_bench
+// and imath_bench_fallback, built with IMATHLIB_FORCE_FALLBACK.
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "imath.h"
+#include "bench.h"
+
+using u32 = uint32_t;
+using u64 = uint64_t;
+using imath::detail::u128;
+
+namespace {
+
+constexpr size_t kInputs = 4096;
+constexpr double kMinMeasurementSeconds = 0.1;
+
+template <typename Input, typename Function>
+double nsPerCall(const std::vector<Input>& inputs, Function function) {
+    size_t rounds = 1;
+    while (true) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t round = 0; round < rounds; ++round) {
+            for (const Input& input : inputs) {
+                bench::doNotOptimize(function(input));
+            }
+        }
+        auto stop = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(stop - start).count();
+        if (seconds >= kMinMeasurementSeconds) {
+            return seconds * 1e9 /
+                   static_cast<double>(rounds * inputs.size());
+        }
+        rounds *= 2;
+    }
+}
+
+struct Differential {
+    const char* filter;
+    size_t total_mismatches;
+
+    template <typename Input, typename Native, typename Fallback>
+    void compare(const char* name, const std::vector<Input>& inputs,
+                 Native native, Fallback fallback) {
+        if (std::strstr(name, filter) == nullptr) return;
+        size_t mismatches = 0;
+        for (const Input& input : inputs) {
+            if (native(input) != fallback(input)) ++mismatches;
+        }
+        double native_ns = nsPerCall(inputs, native);
+        double fallback_ns = nsPerCall(inputs, fallback);
+        std::printf("%-24s %10.2f ns %10.2f ns %8.2fx %10zu%s\n", name,
+                    native_ns, fallback_ns, fallback_ns / native_ns,
+                    mismatches, mismatches != 0 ? "  MISMATCH" : "");
+        std::fflush(stdout);
+        total_mismatches += mismatches;
+    }
+};
+
+template <typename T>
+std::vector<T> randomNumbers(std::mt19937_64& rng) {
+    std::vector<T> result(kInputs);
+    for (T& n : result) {
+        // Uniformly distributed bit lengths
+        n = static_cast<T>(rng() >> (rng() % 64));
+    }
+    return result;
+}
+
+template <typename T>
+std::vector<std::pair<T, T>> randomPairs(std::mt19937_64& rng) {
+    std::vector<T> a = randomNumbers<T>(rng);
+    std::vector<T> b = randomNumbers<T>(rng);
+    std::vector<std::pair<T, T>> result(kInputs);
+    for (size_t i = 0; i < kInputs; ++i) {
+        result[i] = {a[i], b[i]};
+    }
+    return result;
+}
+
+// 0 < n.hi < mod, as mod128by64 expects
+std::vector<std::pair<u128, u64>> randomDivisions(std::mt19937_64& rng) {
+    std::vector<std::pair<u128, u64>> result(kInputs);
+    for (auto& division : result) {
+        u64 mod = (rng() >> (rng() % 63)) | 2;
+        division = {u128{rng() % (mod - 1) + 1, rng()}, mod};
+    }
+    return result;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Differential differential{"", 0};
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--seed=", 7) == 0) {
+            bench::seed() = std::strtoull(argv[i] + 7, nullptr, 10);
+        } else {
+            differential.filter = argv[i];
+        }
+    }
+
+    std::printf("%-24s %13s %13s %9s %10s\n", "function", "native",
+                "fallback", "ratio", "mismatches");
+
+    namespace detail = imath::detail;
+    std::mt19937_64 rng{bench::seed()};
+    const auto numbers32 = randomNumbers<u32>(rng);
+    const auto numbers64 = randomNumbers<u64>(rng);
+    const auto pairs32 = randomPairs<u32>(rng);
+    const auto pairs64 = randomPairs<u64>(rng);
+    const auto divisions = randomDivisions(rng);
+
+    differential.compare("clz_u32", numbers32,
+        [](u32 n) { return detail::clz(n); },
+        [](u32 n) { return detail::clzFallback(n); });
+    differential.compare("clz_u64", numbers64,
+        [](u64 n) { return detail::clz(n); },
+        [](u64 n) { return detail::clzFallback(n); });
+    differential.compare("ctz_u32", numbers32,
+        [](u32 n) { return detail::ctz(n); },
+        [](u32 n) { return detail::ctzFallback(n); });
+    differential.compare("ctz_u64", numbers64,
+        [](u64 n) { return detail::ctz(n); },
+        [](u64 n) { return detail::ctzFallback(n); });
+    differential.compare("mul64x64", pairs64,
+        [](std::pair<u64, u64> p) {
+            u128 r = detail::mul64x64(p.first, p.second);
+            return std::make_pair(r.hi, r.lo);
+        },
+        [](std::pair<u64, u64> p) {
+            u128 r = detail::mul64x64Fallback(p.first, p.second);
+            return std::make_pair(r.hi, r.lo);
+        });
+    differential.compare("mod128by64", divisions,
+        [](std::pair<u128, u64> d) {
+            return detail::mod128by64(d.first, d.second);
+        },
+        [](std::pair<u128, u64> d) {
+            return detail::mod128by64Fallback(d.first, d.second);
+        });
+    differential.compare("gcd_u32", pairs32,
+        [](std::pair<u32, u32> p) {
+            return detail::gcdBinary(p.first, p.second);
+        },
+        [](std::pair<u32, u32> p) {
+            return detail::gcdModuloRecursive(p.first, p.second);
+        });
+    differential.compare("gcd_u64", pairs64,
+        [](std::pair<u64, u64> p) {
+            return detail::gcdBinary(p.first, p.second);
+        },
+        [](std::pair<u64, u64> p) {
+            return detail::gcdModuloRecursive(p.first, p.second);
+        });
+    differential.compare("isqrt_u64", numbers64,
+        [](u64 n) { return imath::isqrt(n); },
+        [](u64 n) { return detail::isqrtNewton(n); });
+    differential.compare("icbrt_u64", numbers64,
+        [](u64 n) { return imath::icbrt(n); },
+        [](u64 n) { return detail::irootNewton(n, 3); });
+
+    return differential.total_mismatches == 0 ? 0 : 1;
+}
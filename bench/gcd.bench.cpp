@@ -0,0 +1,57 @@
+
+//                   Copyright(c) Kamil Kaznowski 2021.
+//         Distributed under the Boost Software License, Version 1.0.
+//                (See accompanying file LICENSE or copy at
+//                  https://www.boost.org/LICENSE_1_0.txt)
+
+// GCD of independent pairs, one by one and elementwise over arrays.
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "imath.h"
+#include "bench.h"
+
+using u64 = uint64_t;
+
+namespace {
+
+constexpr size_t kInputs = 1 << 14;
+
+struct GcdInputs {
+    std::vector<u64> a;
+    std::vector<u64> b;
+};
+
+const GcdInputs& gcdInputs() {
+    static const GcdInputs inputs = [] {
+        std::mt19937_64 rng{bench::seed()};
+        GcdInputs result{std::vector<u64>(kInputs), std::vector<u64>(kInputs)};
+        for (size_t i = 0; i < kInputs; ++i) {
+            u64 common = rng() >> 48;
+            result.a[i] = (rng() >> 16) * common;
+            result.b[i] = (rng() >> 16) * common;
+        }
+        return result;
+    }();
+    return inputs;
+}
+
+}  // namespace
+
+IMATHLIB_BENCHMARK(gcd_u64) {
+    const auto& inputs = gcdInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(imath::gcd(inputs.a[i % kInputs], inputs.b[i % kInputs]));
+    }
+}
+
+IMATHLIB_BENCHMARK(gcd_u64_elementwise) {
+    const auto& inputs = gcdInputs();
+    std::vector<u64> out(kInputs);
+    for (size_t i = 0; i < iterations; i += kInputs) {
+        imath::gcd(inputs.a.data(), inputs.b.data(), kInputs, out.data());
+        bench::doNotOptimize(out[0]);
+    }
+}
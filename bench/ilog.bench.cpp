@@ -0,0 +1,66 @@
+
+//                   Copyright(c) Kamil Kaznowski 2021.
+//         Distributed under the Boost Software License, Version 1.0.
+//                (See accompanying file LICENSE or copy at
+//                  https://www.boost.org/LICENSE_1_0.txt)
+
+// Decimal digit counts, as needed for sizing serialization buffers,
+// and perfect power detection.
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "imath.h"
+#include "bench.h"
+
+using u64 = uint64_t;
+
+namespace {
+
+constexpr size_t kInputs = 1024;
+
+// Uniformly distributed bit lengths, like in typical serialized data
+const std::vector<u64>& logInputs() {
+    static const std::vector<u64> inputs = [] {
+        std::mt19937_64 rng{bench::seed()};
+        std::vector<u64> result(kInputs);
+        for (u64& n : result) {
+            n = rng() >> (rng() % 64);
+        }
+        return result;
+    }();
+    return inputs;
+}
+
+uint32_t ilog10Loop(u64 n) {
+    uint32_t result = 0;
+    while (n >= 10) {
+        n /= 10;
+        ++result;
+    }
+    return result;
+}
+
+}  // namespace
+
+IMATHLIB_BENCHMARK(ilog10_u64) {
+    const auto& inputs = logInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(imath::ilog10(inputs[i % kInputs]));
+    }
+}
+
+IMATHLIB_BENCHMARK(ilog10_u64_loop) {
+    const auto& inputs = logInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(ilog10Loop(inputs[i % kInputs]));
+    }
+}
+
+IMATHLIB_BENCHMARK(isPerfectPower_u64) {
+    const auto& inputs = logInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(imath::isPerfectPower(inputs[i % kInputs]));
+    }
+}
@@ -0,0 +1,89 @@
+
+//                   Copyright(c) Kamil Kaznowski 2021.
+//         Distributed under the Boost Software License, Version 1.0.
+//                (See accompanying file LICENSE or copy at
+//                  https://www.boost.org/LICENSE_1_0.txt)
+
+// Input generators shared by the benchmarks, split by bit length
+// and by the kind of numbers.
+
+#ifndef IMATHLIB_BENCH_INPUTS_H
+#define IMATHLIB_BENCH_INPUTS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "imath.h"
+#include "bench.h"
+
+namespace bench {
+
+enum class NumberClass {
+    kAny,        // uniformly distributed
+    kPrime,
+    kComposite,  // odd, so that it is not rejected by the first check
+    kSemiprime,  // product of two primes of half the bit length
+};
+
+namespace detail {
+
+// Uniformly distributed number of exactly bits bits, 1 <= bits <= 64
+inline uint64_t randomWithBits(std::mt19937_64& rng, int bits) {
+    uint64_t top = uint64_t{1} << (bits - 1);
+    return (rng() & (top - 1)) | top;
+}
+
+inline bool hasBits(uint64_t n, int bits) {
+    return imath::ilog2(n) + 1 == static_cast<uint32_t>(bits);
+}
+
+inline uint64_t randomOfClass(std::mt19937_64& rng, NumberClass number_class,
+                              int bits) {
+    while (true) {
+        uint64_t n = randomWithBits(rng, bits);
+        switch (number_class) {
+        case NumberClass::kAny:
+            return n;
+        case NumberClass::kPrime:
+            if (n >= 18446744073709551557u) continue;  // the largest prime
+            n = imath::nextPrimeAfter(n);
+            if (hasBits(n, bits)) return n;
+            break;
+        case NumberClass::kComposite:
+            n |= 1;
+            if (!imath::isPrime(n)) return n;
+            break;
+        case NumberClass::kSemiprime: {
+            uint64_t p = imath::nextPrimeAfter(randomWithBits(rng, bits / 2));
+            uint64_t q = imath::nextPrimeAfter(
+                randomWithBits(rng, bits - bits / 2));
+            if (imath::ilog2(p) + imath::ilog2(q) + 2 > 64) break;
+            if (hasBits(p * q, bits)) return p * q;
+            break;
+        }
+        }
+    }
+}
+
+}  // namespace detail
+
+/**
+ * count numbers of exactly bits bits and of the given class,
+ * the same for the same seed().
+ * */
+inline std::vector<uint64_t> numbersOfClass(NumberClass number_class,
+                                            int bits, size_t count) {
+    std::mt19937_64 rng{seed() ^ (static_cast<uint64_t>(bits) << 8) ^
+                        static_cast<uint64_t>(number_class)};
+    std::vector<uint64_t> result(count);
+    for (uint64_t& n : result) {
+        n = detail::randomOfClass(rng, number_class, bits);
+    }
+    return result;
+}
+
+}  // namespace bench
+
+#endif  // IMATHLIB_BENCH_INPUTS_H
@@ -0,0 +1,61 @@
+
+//                   Copyright(c) Kamil Kaznowski 2021.
+//         Distributed under the Boost Software License, Version 1.0.
+//                (See accompanying file LICENSE or copy at
+//                  https://www.boost.org/LICENSE_1_0.txt)
+
+// Perfect square test, one by one and in batches.
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "imath.h"
+#include "bench.h"
+
+using u64 = uint64_t;
+
+namespace {
+
+constexpr size_t kInputs = 1 << 16;
+
+// Mostly non-squares, every 16th number is a square.
+// A lot of inputs, so that the branch predictor can't learn them.
+const std::vector<u64>& squareInputs() {
+    static const std::vector<u64> inputs = [] {
+        std::mt19937_64 rng{bench::seed()};
+        std::vector<u64> result(kInputs);
+        for (size_t i = 0; i < kInputs; ++i) {
+            u64 root = rng() >> 32;
+            result[i] = (i % 16 == 0) ? root * root : rng();
+        }
+        return result;
+    }();
+    return inputs;
+}
+
+}  // namespace
+
+IMATHLIB_BENCHMARK(isPerfectSquare_u64) {
+    const auto& inputs = squareInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(imath::isPerfectSquare(inputs[i % kInputs]));
+    }
+}
+
+IMATHLIB_BENCHMARK(isPerfectSquare_u64_batch) {
+    const auto& inputs = squareInputs();
+    std::unique_ptr<bool[]> results{new bool[kInputs]};
+    for (size_t i = 0; i < iterations; i += kInputs) {
+        imath::isPerfectSquare(inputs.data(), kInputs, results.get());
+        bench::doNotOptimize(results[0]);
+    }
+}
+
+IMATHLIB_BENCHMARK(isqrt_u64) {
+    const auto& inputs = squareInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(imath::isqrt(inputs[i % kInputs]));
+    }
+}
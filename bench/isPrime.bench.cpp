@@ -0,0 +1,95 @@
+
+//                   Copyright(c) Kamil Kaznowski 2021.
+//         Distributed under the Boost Software License, Version 1.0.
+//                (See accompanying file LICENSE or copy at
+//                  https://www.boost.org/LICENSE_1_0.txt)
+
+// Primality test and the next prime, by bit length and kind of input.
+// Primes take the most Miller-Rabin rounds, most composites are rejected
+// after the first one, semiprimes are the composites without small factors.
+
+#include <cstdint>
+#include <vector>
+
+#include "imath.h"
+#include "bench.h"
+#include "inputs.h"
+
+using u32 = uint32_t;
+using u64 = uint64_t;
+using bench::NumberClass;
+
+namespace {
+
+constexpr size_t kInputs = 1024;
+
+template <typename T, NumberClass CLASS, int BITS>
+const std::vector<T>& inputs() {
+    static const std::vector<T> result = [] {
+        std::vector<T> numbers;
+        for (u64 n : bench::numbersOfClass(CLASS, BITS, kInputs)) {
+            numbers.push_back(static_cast<T>(n));
+        }
+        return numbers;
+    }();
+    return result;
+}
+
+template <typename T, NumberClass CLASS, int BITS>
+void isPrime(size_t iterations) {
+    const auto& numbers = inputs<T, CLASS, BITS>();
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(imath::isPrime(numbers[i % kInputs]));
+    }
+}
+
+template <typename T, int BITS>
+void nextPrimeAfter(size_t iterations) {
+    const auto& numbers = inputs<T, NumberClass::kAny, BITS>();
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(imath::nextPrimeAfter(numbers[i % kInputs] - 1));
+    }
+}
+
+}  // namespace
+
+IMATHLIB_BENCHMARK(isPrime_u32_16bit_prime) {
+    isPrime<u32, NumberClass::kPrime, 16>(iterations);
+}
+IMATHLIB_BENCHMARK(isPrime_u32_16bit_composite) {
+    isPrime<u32, NumberClass::kComposite, 16>(iterations);
+}
+IMATHLIB_BENCHMARK(isPrime_u32_32bit_prime) {
+    isPrime<u32, NumberClass::kPrime, 32>(iterations);
+}
+IMATHLIB_BENCHMARK(isPrime_u32_32bit_composite) {
+    isPrime<u32, NumberClass::kComposite, 32>(iterations);
+}
+IMATHLIB_BENCHMARK(isPrime_u32_32bit_semiprime) {
+    isPrime<u32, NumberClass::kSemiprime, 32>(iterations);
+}
+IMATHLIB_BENCHMARK(isPrime_u64_48bit_prime) {
+    isPrime<u64, NumberClass::kPrime, 48>(iterations);
+}
+IMATHLIB_BENCHMARK(isPrime_u64_48bit_composite) {
+    isPrime<u64, NumberClass::kComposite, 48>(iterations);
+}
+IMATHLIB_BENCHMARK(isPrime_u64_48bit_semiprime) {
+    isPrime<u64, NumberClass::kSemiprime, 48>(iterations);
+}
+IMATHLIB_BENCHMARK(isPrime_u64_64bit_prime) {
+    isPrime<u64, NumberClass::kPrime, 64>(iterations);
+}
+IMATHLIB_BENCHMARK(isPrime_u64_64bit_composite) {
+    isPrime<u64, NumberClass::kComposite, 64>(iterations);
+}
+IMATHLIB_BENCHMARK(isPrime_u64_64bit_semiprime) {
+    isPrime<u64, NumberClass::kSemiprime, 64>(iterations);
+}
+
+IMATHLIB_BENCHMARK(nextPrimeAfter_u32_32bit) {
+    nextPrimeAfter<u32, 31>(iterations);
+}
+IMATHLIB_BENCHMARK(nextPrimeAfter_u64_64bit) {
+    nextPrimeAfter<u64, 63>(iterations);
+}
@@ -0,0 +1,82 @@
+
+//                   Copyright(c) Kamil Kaznowski 2021.
+//         Distributed under the Boost Software License, Version 1.0.
+//                (See accompanying file LICENSE or copy at
+//                  https://www.boost.org/LICENSE_1_0.txt)
+
+// Runs all registered benchmarks, or only the ones containing
+// the filter argument in their name.
+//
+// Usage: imath_bench [--json] [--seed=N] [filter]
+// --json prints the results as JSON, one benchmark per line,
+// so that results of two releases can be diffed.
+// --seed=N generates other inputs than the default ones.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "bench.h"
+
+namespace {
+
+constexpr double kMinMeasurementSeconds = 0.1;
+
+double measureSeconds(bench::BenchmarkFunction function, size_t iterations) {
+    auto start = std::chrono::steady_clock::now();
+    function(iterations);
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const char* filter = "";
+    bool json = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else if (std::strncmp(argv[i], "--seed=", 7) == 0) {
+            bench::seed() = std::strtoull(argv[i] + 7, nullptr, 10);
+        } else {
+            filter = argv[i];
+        }
+    }
+
+    if (json) {
+        std::printf("{\n  \"seed\": %llu,\n  \"benchmarks\": [",
+                    static_cast<unsigned long long>(bench::seed()));
+    }
+    const char* separator = "\n";
+    for (const bench::Benchmark& benchmark : bench::registry()) {
+        if (std::strstr(benchmark.name, filter) == nullptr) continue;
+
+        // Inputs are generated in the first call, which is not measured
+        benchmark.function(1);
+        size_t iterations = 1;
+        double seconds = measureSeconds(benchmark.function, iterations);
+        while (seconds < kMinMeasurementSeconds) {
+            iterations *= 2;
+            seconds = measureSeconds(benchmark.function, iterations);
+        }
+
+        double ns_per_iteration =
+            seconds * 1e9 / static_cast<double>(iterations);
+        if (json) {
+            std::printf("%s    {\"name\": \"%s\", \"ns_per_iteration\": %.2f, "
+                        "\"iterations\": %zu}",
+                        separator, benchmark.name, ns_per_iteration,
+                        iterations);
+            separator = ",\n";
+        } else {
+            std::printf("%-40s %12.2f ns %14zu iterations\n",
+                        benchmark.name, ns_per_iteration, iterations);
+        }
+        std::fflush(stdout);
+    }
+    if (json) {
+        std::printf("\n  ]\n}\n");
+    }
+}
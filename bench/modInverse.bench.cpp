@@ -0,0 +1,58 @@
+
+//                   Copyright(c) Kamil Kaznowski 2021.
+//         Distributed under the Boost Software License, Version 1.0.
+//                (See accompanying file LICENSE or copy at
+//                  https://www.boost.org/LICENSE_1_0.txt)
+
+// Modular inverse: binary extended GCD, Fermat's little theorem,
+// and Montgomery's trick for arrays.
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "imath.h"
+#include "bench.h"
+
+using u64 = uint64_t;
+
+namespace {
+
+constexpr size_t kInputs = 1 << 12;
+constexpr u64 kPrime = 18446744073709551557u;  // the largest 64-bit prime
+
+const std::vector<u64>& inverseInputs() {
+    static const std::vector<u64> inputs = [] {
+        std::mt19937_64 rng{bench::seed()};
+        std::vector<u64> result(kInputs);
+        for (auto& n : result) n = rng() % (kPrime - 1) + 1;
+        return result;
+    }();
+    return inputs;
+}
+
+}  // namespace
+
+IMATHLIB_BENCHMARK(modInverse_u64) {
+    const auto& inputs = inverseInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(imath::modInverse(inputs[i % kInputs], kPrime));
+    }
+}
+
+IMATHLIB_BENCHMARK(modInverse_u64_powmod) {
+    const auto& inputs = inverseInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(
+            imath::powmod(inputs[i % kInputs], kPrime - 2, kPrime));
+    }
+}
+
+IMATHLIB_BENCHMARK(modInverse_u64_batch) {
+    const auto& inputs = inverseInputs();
+    std::vector<u64> out(kInputs);
+    for (size_t i = 0; i < iterations; i += kInputs) {
+        imath::modInverse(inputs.data(), kInputs, kPrime, out.data());
+        bench::doNotOptimize(out[0]);
+    }
+}
@@ -0,0 +1,334 @@
+
+//                   Copyright(c) Kamil Kaznowski 2021.
+//         Distributed under the Boost Software License, Version 1.0.
+//                (See accompanying file LICENSE or copy at
+//                  https://www.boost.org/LICENSE_1_0.txt)
+
+// 64-bit multiplication and exponentiation modulo,
+// compared with the same operations on builtin 128-bit integers.
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "imath.h"
+#include "bench.h"
+
+using u64 = uint64_t;
+using u128s = imath::detail::u128;
+
+namespace {
+
+constexpr size_t kInputs = 1024;
+
+struct MulModInput {
+    u64 a;
+    u64 b;
+    u64 mod;
+};
+
+// Moduli above 2^32, so that the product has non-empty higher 64 bits
+const std::vector<MulModInput>& mulModInputs() {
+    static const std::vector<MulModInput> inputs = [] {
+        std::mt19937_64 rng{bench::seed()};
+        std::vector<MulModInput> result(kInputs);
+        for (MulModInput& input : result) {
+            input.mod = rng() | (1ull << 32) | 1;
+            input.a = rng() % input.mod;
+            input.b = rng() % input.mod;
+        }
+        return result;
+    }();
+    return inputs;
+}
+
+// One multiplier and modulus below 2^63, as in MulModPrecomp use cases
+struct FixedMultiplierInput {
+    std::vector<u64> numbers;
+    u64 b;
+    u64 mod;
+};
+
+const FixedMultiplierInput& fixedMultiplierInput() {
+    static const FixedMultiplierInput input = [] {
+        std::mt19937_64 rng{bench::seed()};
+        FixedMultiplierInput result{std::vector<u64>(kInputs), 0, 0};
+        result.mod = (rng() >> 1) | (1ull << 32) | 1;
+        result.b = rng() % result.mod;
+        for (u64& number : result.numbers) {
+            number = rng() % result.mod;
+        }
+        return result;
+    }();
+    return input;
+}
+
+#if defined(__SIZEOF_INT128__)
+u64 mulmodBuiltin(u64 a, u64 b, u64 mod) {
+    return static_cast<u64>(__uint128_t{a} * b % mod);
+}
+
+u64 powmodBuiltin(u64 n, u64 pow, u64 mod) {
+    u64 res = 1;
+    while (pow) {
+        if (pow & 1) res = mulmodBuiltin(n, res, mod);
+        n = mulmodBuiltin(n, n, mod);
+        pow >>= 1;
+    }
+    return res;
+}
+#endif
+
+}  // namespace
+
+IMATHLIB_BENCHMARK(mod128by64) {
+    const auto& inputs = mulModInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        const MulModInput& in = inputs[i % kInputs];
+        u128s n{in.a, in.b};
+        bench::doNotOptimize(imath::detail::mod128by64(n, in.mod));
+    }
+}
+
+IMATHLIB_BENCHMARK(mod128by64Fallback) {
+    const auto& inputs = mulModInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        const MulModInput& in = inputs[i % kInputs];
+        u128s n{in.a, in.b};
+        bench::doNotOptimize(imath::detail::mod128by64Fallback(n, in.mod));
+    }
+}
+
+IMATHLIB_BENCHMARK(mod128by64Reciprocal) {
+    const auto& inputs = mulModInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        const MulModInput& in = inputs[i % kInputs];
+        u128s n{in.a, in.b};
+        bench::doNotOptimize(imath::detail::mod128by64Reciprocal(n, in.mod));
+    }
+}
+
+IMATHLIB_BENCHMARK(mulmod_u64) {
+    const auto& inputs = mulModInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        const MulModInput& in = inputs[i % kInputs];
+        bench::doNotOptimize(imath::mulmod(in.a, in.b, in.mod));
+    }
+}
+
+IMATHLIB_BENCHMARK(powmod_u64) {
+    const auto& inputs = mulModInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        const MulModInput& in = inputs[i % kInputs];
+        bench::doNotOptimize(imath::powmod(in.a, in.b, in.mod));
+    }
+}
+
+// 32-bit inputs, so the exponent is only as long as the modulus
+IMATHLIB_BENCHMARK(powmod_u32) {
+    const auto& inputs = mulModInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        const MulModInput& in = inputs[i % kInputs];
+        bench::doNotOptimize(imath::powmod(static_cast<uint32_t>(in.a),
+                                           static_cast<uint32_t>(in.b),
+                                           static_cast<uint32_t>(in.mod)));
+    }
+}
+
+// Inverses by Fermat's little theorem, with a prime known only at runtime
+IMATHLIB_BENCHMARK(powmod_u64_fixed_exponent) {
+    const auto& inputs = mulModInputs();
+    // volatile, so that the compiler cannot divide by a constant
+    const volatile u64 largest_prime = 18446744073709551557ull;
+    u64 prime = largest_prime;
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(imath::powmod<18446744073709551557ull - 2>(
+            inputs[i % kInputs].a, prime));
+    }
+}
+
+IMATHLIB_BENCHMARK(powmod_u64_runtime_exponent) {
+    const auto& inputs = mulModInputs();
+    const volatile u64 largest_prime = 18446744073709551557ull;
+    u64 prime = largest_prime;
+    u64 exponent = largest_prime - 2;
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(
+            imath::powmod(inputs[i % kInputs].a, exponent, prime));
+    }
+}
+
+// Four bases to one power, as in the Miller-Rabin rounds of isPrime
+IMATHLIB_BENCHMARK(powmod_u64_4_bases) {
+    const auto& inputs = mulModInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        const MulModInput& in = inputs[i % kInputs];
+        for (size_t j = 0; j < 4; ++j) {
+            bench::doNotOptimize(
+                imath::powmod(inputs[(i + j) % kInputs].a, in.b, in.mod));
+        }
+    }
+}
+
+IMATHLIB_BENCHMARK(powmodMulti_u64_4_bases) {
+    const auto& inputs = mulModInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        const MulModInput& in = inputs[i % kInputs];
+        u64 bases[4];
+        for (size_t j = 0; j < 4; ++j) {
+            bases[j] = inputs[(i + j) % kInputs].a;
+        }
+        imath::powmodMulti(bases, 4, in.b, in.mod, bases);
+        bench::doNotOptimize(bases);
+    }
+}
+
+IMATHLIB_BENCHMARK(powmod2_u64) {
+    const auto& inputs = mulModInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        const MulModInput& in = inputs[i % kInputs];
+        const MulModInput& next = inputs[(i + 1) % kInputs];
+        bench::doNotOptimize(
+            imath::powmod2(in.a, in.b, next.a, next.b, in.mod));
+    }
+}
+
+IMATHLIB_BENCHMARK(mulmod_u64_fixed_multiplier) {
+    const auto& input = fixedMultiplierInput();
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(
+            imath::mulmod(input.numbers[i % kInputs], input.b, input.mod));
+    }
+}
+
+IMATHLIB_BENCHMARK(mulModPrecomp_u64) {
+    const auto& input = fixedMultiplierInput();
+    const imath::MulModPrecomp precomp{input.b, input.mod};
+    for (size_t i = 0; i < iterations; ++i) {
+        bench::doNotOptimize(precomp.mul(input.numbers[i % kInputs]));
+    }
+}
+
+IMATHLIB_BENCHMARK(mulmod_u64_array) {
+    const auto& input = fixedMultiplierInput();
+    std::vector<u64> out(kInputs);
+    for (size_t i = 0; i < iterations; i += kInputs) {
+        imath::mulmod(input.numbers.data(), kInputs, input.b, input.mod,
+                      out.data());
+        bench::doNotOptimize(out[0]);
+    }
+}
+
+namespace {
+
+// A chain of multiplications by inputs below every modulus,
+// the modulus is a constant for mulmod, so that only ModInt differs
+template <u64 M>
+void mulmodChain(size_t iterations) {
+    const auto& inputs = mulModInputs();
+    u64 product = 1;
+    for (size_t i = 0; i < iterations; ++i) {
+        product = imath::mulmod(product, inputs[i % kInputs].a >> 34, M);
+    }
+    bench::doNotOptimize(product);
+}
+
+// Values stay in ModInt, as they would between the operations
+template <u64 M>
+void modIntChain(size_t iterations) {
+    const auto& inputs = mulModInputs();
+    std::vector<imath::ModInt<M>> factors(kInputs);
+    for (size_t i = 0; i < kInputs; ++i) {
+        factors[i] = imath::ModInt<M>{inputs[i].a >> 34};
+    }
+    imath::ModInt<M> product{1};
+    for (size_t i = 0; i < iterations; ++i) {
+        product *= factors[i % kInputs];
+    }
+    bench::doNotOptimize(product);
+}
+
+}  // namespace
+
+IMATHLIB_BENCHMARK(mulmod_u64_998244353) {
+    mulmodChain<998244353>(iterations);
+}
+
+IMATHLIB_BENCHMARK(modInt_998244353) {
+    modIntChain<998244353>(iterations);
+}
+
+IMATHLIB_BENCHMARK(mulmod_u64_mersenne61) {
+    mulmodChain<(u64{1} << 61) - 1>(iterations);
+}
+
+IMATHLIB_BENCHMARK(modInt_mersenne61) {
+    modIntChain<(u64{1} << 61) - 1>(iterations);
+}
+
+IMATHLIB_BENCHMARK(mulmod_u64_odd_62bit) {
+    mulmodChain<(u64{1} << 62) + 135>(iterations);
+}
+
+IMATHLIB_BENCHMARK(modInt_odd_62bit) {
+    modIntChain<(u64{1} << 62) + 135>(iterations);
+}
+
+IMATHLIB_BENCHMARK(mulmod_u64_even_62bit) {
+    mulmodChain<(u64{1} << 62) + 2>(iterations);
+}
+
+IMATHLIB_BENCHMARK(modInt_even_62bit) {
+    modIntChain<(u64{1} << 62) + 2>(iterations);
+}
+
+IMATHLIB_BENCHMARK(mulmodMersenne61) {
+    const auto& inputs = mulModInputs();
+    u64 product = 1;
+    for (size_t i = 0; i < iterations; ++i) {
+        product = imath::mulmodMersenne61(product, inputs[i % kInputs].a);
+    }
+    bench::doNotOptimize(product);
+}
+
+IMATHLIB_BENCHMARK(mulmodMersenne61_array) {
+    const auto& input = fixedMultiplierInput();
+    std::vector<u64> out(kInputs);
+    for (size_t i = 0; i < iterations; i += kInputs) {
+        imath::mulmodMersenne61(input.numbers.data(), kInputs, input.b,
+                                out.data());
+        bench::doNotOptimize(out[0]);
+    }
+}
+
+IMATHLIB_BENCHMARK(mulmod_u64_pseudo_mersenne) {
+    mulmodChain<UINT64_MAX - 58>(iterations);
+}
+
+IMATHLIB_BENCHMARK(pseudoMersenne_u64) {
+    const auto& inputs = mulModInputs();
+    u64 product = 1;
+    for (size_t i = 0; i < iterations; ++i) {
+        product = imath::PseudoMersenne<59>::mul(product,
+                                                 inputs[i % kInputs].a);
+    }
+    bench::doNotOptimize(product);
+}
+
+#if defined(__SIZEOF_INT128__)
+IMATHLIB_BENCHMARK(mulmod_u64_builtin_u128) {
+    const auto& inputs = mulModInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        const MulModInput& in = inputs[i % kInputs];
+        bench::doNotOptimize(mulmodBuiltin(in.a, in.b, in.mod));
+    }
+}
+
+IMATHLIB_BENCHMARK(powmod_u64_builtin_u128) {
+    const auto& inputs = mulModInputs();
+    for (size_t i = 0; i < iterations; ++i) {
+        const MulModInput& in = inputs[i % kInputs];
+        bench::doNotOptimize(powmodBuiltin(in.a, in.b, in.mod));
+    }
+}
+#endif
@@ -0,0 +1,79 @@
+
+//                   Copyright(c) Kamil Kaznowski 2021.
+//         Distributed under the Boost Software License, Version 1.0.
+//                (See accompanying file LICENSE or copy at
+//                  https://www.boost.org/LICENSE_1_0.txt)
+
+// Number-theoretic transforms of 2^16 and 2^20 points, and convolutions.
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "imath.h"
+#include "bench.h"
+
+using u32 = uint32_t;
+using u64 = uint64_t;
+
+namespace {
+
+constexpr u32 kPrime32 = 998244353;                // 119 * 2^23 + 1
+constexpr u64 kPrime64 = 4179340454199820289ull;  // 29 * 2^57 + 1
+
+template <typename T>
+const imath::Ntt<T>& ntt(T mod) {
+    static const imath::Ntt<T> instance{mod, size_t{1} << 20};
+    return instance;
+}
+
+template <typename T>
+std::vector<T> randomData(size_t size, T mod) {
+    std::mt19937_64 rng{bench::seed()};
+    std::vector<T> data(size);
+    for (auto& x : data) x = static_cast<T>(rng() % mod);
+    return data;
+}
+
+// Reported time is per point
+template <typename T>
+void benchForward(size_t iterations, size_t size, T mod) {
+    auto data = randomData<T>(size, mod);
+    for (size_t i = 0; i < iterations; i += size) {
+        ntt(mod).forward(data.data(), size);
+        bench::doNotOptimize(data[0]);
+    }
+}
+
+// Reported time is per convolution
+template <typename T>
+void benchConvolution(size_t iterations, size_t size, T mod) {
+    auto a = randomData<T>(size / 2, mod);
+    std::vector<T> out(size);
+    for (size_t i = 0; i < iterations; ++i) {
+        ntt(mod).convolve(a.data(), a.size(), a.data(), a.size(), out.data());
+        bench::doNotOptimize(out[0]);
+    }
+}
+
+}  // namespace
+
+IMATHLIB_BENCHMARK(ntt_u32_forward_2to16) {
+    benchForward(iterations, size_t{1} << 16, kPrime32);
+}
+
+IMATHLIB_BENCHMARK(ntt_u32_forward_2to20) {
+    benchForward(iterations, size_t{1} << 20, kPrime32);
+}
+
+IMATHLIB_BENCHMARK(ntt_u64_forward_2to20) {
+    benchForward(iterations, size_t{1} << 20, kPrime64);
+}
+
+IMATHLIB_BENCHMARK(ntt_u32_convolution_2to16) {
+    benchConvolution(iterations, size_t{1} << 16, kPrime32);
+}
+
+IMATHLIB_BENCHMARK(ntt_u64_convolution_2to16) {
+    benchConvolution(iterations, size_t{1} << 16, kPrime64);
+}
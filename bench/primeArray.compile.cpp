@@ -0,0 +1,14 @@
+
+//                   Copyright(c) Kamil Kaznowski 2021.
+//         Distributed under the Boost Software License, Version 1.0.
+//                (See accompanying file LICENSE or copy at
+//                  https://www.boost.org/LICENSE_1_0.txt)
+
+// Compile-time benchmark, building this file is the measurement.
+
+#include <cstdint>
+
+#include "imath.h"
+
+constexpr imath::PrimeArray<100000> kPrimes;
+static_assert(kPrimes.back() == 1299709, "the 100000th prime");
@@ -30,6 +30,10 @@ static_assert(-2ll >> 1 == -1ll,
 #include <utility>
 #include <cmath>
 #include <cstdint>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <chrono>
 
 static_assert(static_cast<int32_t>(uint32_t{4294967295u}) == -1,
               "Integers must be 2's complement and static_cast uint->int "
@@ -44,14 +48,96 @@ static_assert(static_cast<int32_t>(uint32_t{4294967295u}) == -1,
 #include <immintrin.h>
 #endif
 
+// Define IMATHLIB_FORCE_FALLBACK to 1 to replace intrinsics, assembly,
+// builtin 128-bit integers, AVX2 and floating point roots with their
+// portable fallbacks, to measure what they give on a platform.
+#if !defined(IMATHLIB_FORCE_FALLBACK)
+#define IMATHLIB_FORCE_FALLBACK 0
+#endif
+
+#if defined(__AVX2__) && !IMATHLIB_FORCE_FALLBACK
+#include <immintrin.h>
+#define IMATHLIB_AVX2 1
+#endif
+
+// Define IMATHLIB_ENABLE_AVX2_DISPATCH to 1 to check the CPU features
+// with cpuid once, at startup, on x86-64. Builds without -mavx2 then compile
+// the AVX2 kernels anyway, with a target attribute on GCC and Clang, and use
+// them only if the CPU supports them. It is opt-in, as <immintrin.h> makes
+// compiling every includer several times slower.
+#if !defined(IMATHLIB_ENABLE_AVX2_DISPATCH)
+#define IMATHLIB_ENABLE_AVX2_DISPATCH 0
+#endif
+
+#if (defined(__x86_64__) || defined(_M_X64)) && !IMATHLIB_FORCE_FALLBACK && \
+    (defined(__GNUC__) || defined(_MSC_VER)) && IMATHLIB_ENABLE_AVX2_DISPATCH
+#define IMATHLIB_HAS_CPUID 1
+#if defined(__GNUC__)
+#include <cpuid.h>
+#endif
+#if !IMATHLIB_AVX2
+#include <immintrin.h>
+#define IMATHLIB_AVX2_DISPATCH 1
+#if defined(__GNUC__)
+// LZCNT, TZCNT and MULX come with AVX2 on all CPUs, so the kernels use them too
+#define IMATHLIB_TARGET_AVX2 __attribute__((target("avx2,bmi,bmi2,lzcnt")))
+#endif
+#endif
+#endif
+
+#if IMATHLIB_AVX2 || IMATHLIB_AVX2_DISPATCH
+#define IMATHLIB_AVX2_KERNELS 1
+#endif
+#if !defined(IMATHLIB_TARGET_AVX2)
+#define IMATHLIB_TARGET_AVX2
+#endif
+
+// Builtin 128-bit integers for runtime arithmetic. Whether they are
+// available for constexpr depends only on the compiler
+#if defined(__SIZEOF_INT128__) && !IMATHLIB_FORCE_FALLBACK
+#define IMATHLIB_HAS_INT128 1
+#endif
+
+// Without exceptions, failures of the standard library, like a thread
+// which can't be started, terminate the program
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define IMATHLIB_HAS_EXCEPTIONS 1
+#endif
+
+// factorizeParallel starts threads, so it is there only with
+// IMATHLIB_ENABLE_THREADS defined to 1, and the program linked with
+// the threads library (-pthread). Others don't pay for <thread>
+#if !defined(IMATHLIB_ENABLE_THREADS)
+#define IMATHLIB_ENABLE_THREADS 0
+#endif
+
+#if IMATHLIB_ENABLE_THREADS
+#include <system_error>
+#include <thread>
+#endif
+
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+// GCC and Clang provide std::is_constant_evaluated() as a builtin,
+// available also in C++14 and C++17 modes
+#define IMATHLIB_HAS_BUILTIN_CONSTEVAL 1
+#endif
+#elif defined(__GNUC__) && __GNUC__ >= 9
+#define IMATHLIB_HAS_BUILTIN_CONSTEVAL 1
+#endif
+
 #if __cpp_lib_is_constant_evaluated
 #define IMATHLIB_CONSTEXPR20 constexpr
 #define IMATHLIB_HAS_CONSTEXPR20 1
 #define IMATHLIB_IS_CONSTEVAL std::is_constant_evaluated()
 #else
 #define IMATHLIB_CONSTEXPR20 inline
+#if IMATHLIB_HAS_BUILTIN_CONSTEVAL
+#define IMATHLIB_IS_CONSTEVAL __builtin_is_constant_evaluated()
+#else
 #define IMATHLIB_IS_CONSTEVAL 0
 #endif
+#endif
 
 #if IMATHLIB_HAS_CONSTEXPR20 || !defined(_MSC_VER)
 // Support for intrinsics in constexpr or C++20 is_consteval
@@ -65,6 +151,8 @@ static_assert(static_cast<int32_t>(uint32_t{4294967295u}) == -1,
 // (like in very old libc++), you may want to change this flag to 0.
 // It will disable a lot of constexpr, but will use inline assembly for
 // 128bit % 64bit modulo.
+// GCC and Clang with __builtin_is_constant_evaluated use inline assembly
+// at runtime anyway, so this flag only matters for the constant evaluation.
 #define IMATHLIB_FAST_LIBRARY_MODULO 1
 
 #if IMATHLIB_HAS_CONSTEXPR20 || \
@@ -104,12 +192,49 @@ static_assert(static_cast<int32_t>(uint32_t{4294967295u}) == -1,
 #endif
 #endif  // !defined(IMATHLIB_ASSUME)
 
+// Define IMATHLIB_STATS to 1 to count what factorize and isPrime do
+// internally, in thread-local counters, see imath::Stats.
+// Counting is skipped in constant evaluation, which needs a working
+// IMATHLIB_IS_CONSTEVAL. When it is 0, the macros compile to nothing.
+#if !defined(IMATHLIB_STATS)
+#define IMATHLIB_STATS 0
+#endif
+
+#if IMATHLIB_STATS
+#define IMATHLIB_STATS_ADD(counter, value)                                   \
+    (IMATHLIB_IS_CONSTEVAL                                                   \
+         ? void()                                                            \
+         : void(::imath::detail::threadStats().counter += (value)))
+#define IMATHLIB_STATS_MAX(counter, value)                                   \
+    (IMATHLIB_IS_CONSTEVAL                                                   \
+         ? void()                                                            \
+         : ::imath::detail::statsMax(::imath::detail::threadStats().counter, \
+                                     (value)))
+#define IMATHLIB_STATS_TIMER(name) \
+    const uint64_t name = IMATHLIB_IS_CONSTEVAL ? 0 : ::imath::detail::statsClock()
+#define IMATHLIB_STATS_ELAPSED(name, counter) \
+    IMATHLIB_STATS_ADD(counter, ::imath::detail::statsClock() - (name))
+#else
+#define IMATHLIB_STATS_ADD(counter, value) void()
+#define IMATHLIB_STATS_MAX(counter, value) void()
+#define IMATHLIB_STATS_TIMER(name) void()
+#define IMATHLIB_STATS_ELAPSED(name, counter) void()
+#endif
+
 #ifdef _MSC_VER
 #define IMATHLIB_MSC_WARNING(id) __pragma(warning(suppress : id))
 #else
 #define IMATHLIB_MSC_WARNING(id)
 #endif
 
+// Whether the optimizer knows the value, like a constant modulus passed
+// to an inlined function, so that % becomes a multiplication
+#if (defined(__GNUG__) || defined(__clang__)) && !IMATHLIB_FORCE_FALLBACK
+#define IMATHLIB_KNOWN_CONSTANT(x) __builtin_constant_p(x)
+#else
+#define IMATHLIB_KNOWN_CONSTANT(x) 0
+#endif
+
 namespace imath {
 
 // This is the public interface of imath library.
@@ -129,8 +254,22 @@ class FactorizationResultU64;
 IMATHLIB_CONSTEXPR_INTR FactorizationResultU32 factorize(uint32_t) noexcept;
 IMATHLIB_CONSTEXPR_X64 FactorizationResultU64 factorize(uint64_t) noexcept;
 
+struct CofactorU64;
+class PartialFactorizationU64;
+
+IMATHLIB_CONSTEXPR_X64 PartialFactorizationU64 factorizeWithBudget(
+    uint64_t n, uint64_t max_iterations) noexcept;
+inline PartialFactorizationU64 factorizeWithDeadline(
+    uint64_t n, std::chrono::steady_clock::time_point deadline) noexcept;
+#if IMATHLIB_ENABLE_THREADS
+inline FactorizationResultU64 factorizeParallel(uint64_t n,
+                                                unsigned threads = 0) noexcept;
+#endif
+
 template <size_t SIZE, typename T = uint32_t>
 class PrimeArray;
+template <size_t N>
+class FactorTable;
 
 constexpr uint32_t pow(uint32_t n, uint32_t pow) noexcept;
 constexpr uint64_t pow(uint64_t n, uint64_t pow) noexcept;
@@ -139,29 +278,191 @@ constexpr uint32_t mulmod(uint32_t a, uint32_t b, uint32_t mod);
 IMATHLIB_CONSTEXPR_X64 uint64_t mulmod(uint64_t a, uint64_t b, uint64_t mod);
 constexpr uint32_t powmod(uint32_t n, uint32_t pow, uint32_t mod);
 IMATHLIB_CONSTEXPR_X64 uint64_t powmod(uint64_t n, uint64_t pow, uint64_t mod);
+template <uint64_t E>
+constexpr uint32_t powmod(uint32_t n, uint32_t mod);
+template <uint64_t E>
+IMATHLIB_CONSTEXPR_X64 uint64_t powmod(uint64_t n, uint64_t mod);
+IMATHLIB_CONSTEXPR_X64 void powmodMulti(const uint64_t* bases, size_t count,
+                                        uint64_t pow, uint64_t mod,
+                                        uint64_t* out);
+constexpr uint32_t powmod2(uint32_t a, uint32_t x, uint32_t b, uint32_t y,
+                           uint32_t mod);
+IMATHLIB_CONSTEXPR_X64 uint64_t powmod2(uint64_t a, uint64_t x, uint64_t b,
+                                        uint64_t y, uint64_t mod);
+
+class MulModPrecomp;
+
+IMATHLIB_CONSTEXPR_X64 void mulmod(const uint64_t* numbers, size_t count,
+                                   const MulModPrecomp& b, uint64_t* out);
+IMATHLIB_CONSTEXPR_X64 void mulmod(const uint64_t* numbers, size_t count,
+                                   uint64_t b, uint64_t mod, uint64_t* out);
+
+IMATHLIB_CONSTEXPR_X64 uint64_t mulmodMersenne61(uint64_t a,
+                                                 uint64_t b) noexcept;
+IMATHLIB_CONSTEXPR_X64 void mulmodMersenne61(const uint64_t* numbers,
+                                             size_t count, uint64_t b,
+                                             uint64_t* out) noexcept;
+template <uint64_t C>
+class PseudoMersenne;
+
+class FactorizationCache;
+
+#if IMATHLIB_STATS
+struct Stats;
+inline Stats statsSnapshot() noexcept;
+inline void resetStats() noexcept;
+#endif
 
 IMATHLIB_CONSTEXPR_INTR uint32_t gcd(uint32_t a, uint32_t b) noexcept;
 IMATHLIB_CONSTEXPR_INTR uint64_t gcd(uint64_t a, uint64_t b) noexcept;
 IMATHLIB_CONSTEXPR_INTR uint32_t lcm(uint32_t a, uint32_t b) noexcept;
 IMATHLIB_CONSTEXPR_INTR uint64_t lcm(uint64_t a, uint64_t b) noexcept;
 
+IMATHLIB_CONSTEXPR_INTR uint32_t gcdReduce(const uint32_t* numbers,
+                                           size_t count) noexcept;
+IMATHLIB_CONSTEXPR_INTR uint64_t gcdReduce(const uint64_t* numbers,
+                                           size_t count) noexcept;
+IMATHLIB_CONSTEXPR_INTR uint32_t lcmReduce(const uint32_t* numbers,
+                                           size_t count) noexcept;
+IMATHLIB_CONSTEXPR_INTR uint64_t lcmReduce(const uint64_t* numbers,
+                                           size_t count) noexcept;
+inline void gcd(const uint32_t* a, const uint32_t* b, size_t count,
+                uint32_t* out) noexcept;
+inline void gcd(const uint64_t* a, const uint64_t* b, size_t count,
+                uint64_t* out) noexcept;
+
+struct ExtendedGcdU32;
+struct ExtendedGcdU64;
+
+constexpr ExtendedGcdU32 extendedGcd(uint32_t a, uint32_t b) noexcept;
+constexpr ExtendedGcdU64 extendedGcd(uint64_t a, uint64_t b) noexcept;
+IMATHLIB_CONSTEXPR_INTR uint32_t modInverse(uint32_t n, uint32_t mod);
+IMATHLIB_CONSTEXPR_X64 uint64_t modInverse(uint64_t n, uint64_t mod);
+IMATHLIB_CONSTEXPR_INTR void modInverse(const uint32_t* numbers, size_t count,
+                                        uint32_t mod, uint32_t* out);
+IMATHLIB_CONSTEXPR_X64 void modInverse(const uint64_t* numbers, size_t count,
+                                       uint64_t mod, uint64_t* out);
+
+struct CrtU128;
+template <size_t SIZE>
+class CrtBasis;
+
+IMATHLIB_CONSTEXPR_INTR uint32_t nttPrime(uint32_t upper_bound,
+                                          uint32_t log_size);
+IMATHLIB_CONSTEXPR_X64 uint64_t nttPrime(uint64_t upper_bound,
+                                         uint32_t log_size);
+
+template <typename T>
+class Ntt;
+
+template <uint64_t M>
+class ModInt;
+
+template <typename T, bool BRANCHFREE = false>
+class Divider;
+
 constexpr uint32_t roundUpToMultipleOf(uint32_t n, uint32_t mul);
 constexpr uint64_t roundUpToMultipleOf(uint64_t n, uint64_t mul);
 constexpr uint32_t roundDownToMultipleOf(uint32_t n, uint32_t mul);
 constexpr uint64_t roundDownToMultipleOf(uint64_t n, uint64_t mul);
-
-// class MontgomerySpaceU32;
-// class MontgomeryU32;
-// class MontgomerySpaceU64;
-// class MontgomeryU64;
-
-IMATHLIB_CONSTEXPR20 bool isPerfectSquare(uint32_t n) noexcept;
-IMATHLIB_CONSTEXPR20 bool isPerfectSquare(uint64_t n) noexcept;
+template <typename T, bool BRANCHFREE>
+IMATHLIB_CONSTEXPR_X64 T roundUpToMultipleOf(
+    T n, const Divider<T, BRANCHFREE>& mul);
+template <typename T, bool BRANCHFREE>
+IMATHLIB_CONSTEXPR_X64 T roundDownToMultipleOf(
+    T n, const Divider<T, BRANCHFREE>& mul);
+
+IMATHLIB_CONSTEXPR_INTR uint32_t isqrt(uint32_t n) noexcept;
+IMATHLIB_CONSTEXPR_INTR uint64_t isqrt(uint64_t n) noexcept;
+IMATHLIB_CONSTEXPR_INTR uint32_t icbrt(uint32_t n) noexcept;
+IMATHLIB_CONSTEXPR_INTR uint64_t icbrt(uint64_t n) noexcept;
+IMATHLIB_CONSTEXPR_INTR uint32_t iroot(uint32_t n, uint32_t k);
+IMATHLIB_CONSTEXPR_INTR uint64_t iroot(uint64_t n, uint32_t k);
+
+IMATHLIB_CONSTEXPR_INTR bool isPerfectSquare(uint32_t n) noexcept;
+IMATHLIB_CONSTEXPR_INTR bool isPerfectSquare(uint64_t n) noexcept;
+inline void isPerfectSquare(const uint64_t* numbers, size_t count,
+                            bool* results) noexcept;
+
+struct PerfectPowerU32;
+struct PerfectPowerU64;
+
+IMATHLIB_CONSTEXPR_INTR PerfectPowerU32 isPerfectPower(uint32_t n) noexcept;
+IMATHLIB_CONSTEXPR_INTR PerfectPowerU64 isPerfectPower(uint64_t n) noexcept;
+
+IMATHLIB_CONSTEXPR_INTR uint32_t ilog2(uint32_t n) noexcept;
+IMATHLIB_CONSTEXPR_INTR uint32_t ilog2(uint64_t n) noexcept;
+IMATHLIB_CONSTEXPR_INTR uint32_t ilog10(uint32_t n) noexcept;
+IMATHLIB_CONSTEXPR_INTR uint32_t ilog10(uint64_t n) noexcept;
+IMATHLIB_CONSTEXPR_INTR uint32_t ilog(uint32_t n, uint32_t base);
+IMATHLIB_CONSTEXPR_INTR uint32_t ilog(uint64_t n, uint64_t base);
 
 // End of public interface
 
+#if IMATHLIB_STATS
+/**
+ * Counters of factorize and isPrime internals, for the calling thread.
+ * Times are in nanoseconds, and the stages are timed only in factorize.
+ * Work of the threads of factorizeParallel counts for its caller.
+ * */
+struct Stats {
+    uint64_t factorize_calls;
+    uint64_t trial_division_hits;  // prime factors found by trial division
+    uint64_t isprime_calls;
+    uint64_t sprp_rounds;          // Miller-Rabin rounds
+    uint64_t rho_calls;
+    uint64_t rho_retries;          // rho runs which found no divisor
+    uint64_t rho_iterations;       // evaluations of the polynomial
+    uint64_t gcd_calls;            // gcds in rho
+    uint64_t max_composite_stack;  // composite divisors waiting for rho
+    uint64_t trial_division_ns;
+    uint64_t primality_ns;
+    uint64_t perfect_power_ns;
+    uint64_t rho_ns;
+};
+#endif
+
 namespace detail {
 
+#if IMATHLIB_STATS
+inline Stats& threadStats() noexcept {
+    static thread_local Stats stats{};
+    return stats;
+}
+
+inline void statsMax(uint64_t& counter, uint64_t value) noexcept {
+    if (value > counter) counter = value;
+}
+
+inline uint64_t statsClock() noexcept {
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+#if IMATHLIB_ENABLE_THREADS
+/**
+ * Counters of another thread, added to the calling thread's ones.
+ * */
+inline void statsAdd(const Stats& other) noexcept {
+    Stats& stats = threadStats();
+    stats.factorize_calls += other.factorize_calls;
+    stats.trial_division_hits += other.trial_division_hits;
+    stats.isprime_calls += other.isprime_calls;
+    stats.sprp_rounds += other.sprp_rounds;
+    stats.rho_calls += other.rho_calls;
+    stats.rho_retries += other.rho_retries;
+    stats.rho_iterations += other.rho_iterations;
+    stats.gcd_calls += other.gcd_calls;
+    statsMax(stats.max_composite_stack, other.max_composite_stack);
+    stats.trial_division_ns += other.trial_division_ns;
+    stats.primality_ns += other.primality_ns;
+    stats.perfect_power_ns += other.perfect_power_ns;
+    stats.rho_ns += other.rho_ns;
+}
+#endif
+#endif
+
 struct u128 {
     uint64_t hi;
     uint64_t lo;
@@ -266,11 +567,18 @@ IMATHLIB_MSC_WARNING(4146)
     return detail::power_of_2_lookup_array_32[n];
 }
 
+// MSVC has no builtin with the zero check done by the instruction, so clz
+// and ctz check for zero and use BSR or BSF. LZCNT and TZCNT are known to
+// be available only at runtime, see CpuFeatures, and checking for them
+// would cost as much as the zero check.
+
 IMATHLIB_CONSTEXPR_INTR int clz(uint64_t n) noexcept {
     if (IMATHLIB_IS_CONSTEVAL) {
         return clzFallback(n);
     }
-#if (defined(__GNUG__) || defined(__clang__))
+#if IMATHLIB_FORCE_FALLBACK
+    return clzFallback(n);
+#elif (defined(__GNUG__) || defined(__clang__))
 #if INTPTR_MAX == INT64_MAX
 #define IMATHLIB_FAST_CLZ64
     if (n == 0) return 64;
@@ -282,7 +590,6 @@ IMATHLIB_CONSTEXPR_INTR int clz(uint64_t n) noexcept {
 #elif defined(_MSC_VER)
 #if defined(_M_X64) || defined(_M_ARM64)
 #define IMATHLIB_FAST_CLZ64
-    // There is no good way to check for LZCNT instruction availability
     if (n == 0) return 64;
     unsigned long index = 0;
     (void)_BitScanReverse64(&index, n);
@@ -306,7 +613,9 @@ IMATHLIB_CONSTEXPR_INTR int clz(uint32_t n) noexcept {
     // There is CLZ instruction on 32-bit ARMv5 and above architectures,
     // So use builtins whenever possible. No checks for ARMs < 5,
     // cause it would require a lot of boilerplate
-#if IMATHLIB_CPP_VER >= 202002L
+#if IMATHLIB_FORCE_FALLBACK
+    return clzFallback(n);
+#elif IMATHLIB_CPP_VER >= 202002L
 #define IMATHLIB_FAST_CLZ32
     return std::countl_zero(n);
 #elif defined(__GNUG__) || defined(__clang__)
@@ -315,7 +624,6 @@ IMATHLIB_CONSTEXPR_INTR int clz(uint32_t n) noexcept {
     return __builtin_clz(n);
 #elif defined (_MSC_VER)
 #define IMATHLIB_FAST_CLZ32
-    // There is no good way to check for LZCNT instruction availability
     if (n == 0) return 32;
     unsigned long index = 0;
     (void)_BitScanReverse(&index, n);
@@ -333,7 +641,9 @@ IMATHLIB_CONSTEXPR_INTR int ctz(uint64_t n) noexcept {
     // This one is tricky
     // We DON'T want intrinsics on 32-bit architectures
     // cause they emit very long code or function call.
-#if (defined(__GNUG__) || defined(__clang__))
+#if IMATHLIB_FORCE_FALLBACK
+    return ctzFallback(n);
+#elif (defined(__GNUG__) || defined(__clang__))
 #if INTPTR_MAX == INT64_MAX
 #define IMATHLIB_FAST_CTZ64
     if (n == 0) return 64;
@@ -345,7 +655,6 @@ IMATHLIB_CONSTEXPR_INTR int ctz(uint64_t n) noexcept {
 #elif defined(_MSC_VER)
 #if defined(_M_X64) || defined(_M_ARM64)
 #define IMATHLIB_FAST_CTZ64
-    // There is no good way to check for TZCNT instruction availability
     if (n == 0) return 64;
     unsigned long index = 0;
     (void)_BitScanForward64(&index, n);
@@ -367,7 +676,9 @@ IMATHLIB_CONSTEXPR_INTR int ctz(uint32_t n) noexcept {
         return ctzFallback(n);
     }
 
-#if (defined(__GNUG__) || defined(__clang__))
+#if IMATHLIB_FORCE_FALLBACK
+    return ctzFallback(n);
+#elif (defined(__GNUG__) || defined(__clang__))
 #define IMATHLIB_FAST_CTZ32
     if (n == 0) return 32;
     return __builtin_ctz(n);
@@ -375,7 +686,6 @@ IMATHLIB_CONSTEXPR_INTR int ctz(uint32_t n) noexcept {
     return std::countr_zero(n);
 #elif defined(_MSC_VER) && !defined(_M_ARM)
 #define IMATHLIB_FAST_CTZ32
-    // There is no good way to check for TZCNT instruction availibility
     if (n == 0) return 32;
     unsigned long index = 0;
     (void)_BitScanForward(&index, n);
@@ -406,7 +716,9 @@ IMATHLIB_CONSTEXPR_INTR T gcdBinary(T a, T b) noexcept {
     if (b == 0) return a;
 
     int common_tz = detail::ctz(a | b);
-    b >>= common_tz;
+    // b must be odd, otherwise a - b would stay odd in the loop below,
+    // and a would be decreased by b linearly, without any shifts.
+    b >>= detail::ctz(b);
 
     // Do not change it to do-while loop! Clang gets weirdly confused
     // and checks for 0 twice, conditionaly moving 32/64 to eax/rax
@@ -427,6 +739,261 @@ IMATHLIB_CONSTEXPR_INTR T gcdBinary(T a, T b) noexcept {
     return b << common_tz;
 }
 
+/**
+ * Binary GCD of kLanes independent pairs at once.
+ * Loops of the algorithm above have a long dependency chain (ctz, shift,
+ * compare, cmov, subtract), so interleaving a few of them lets the processor
+ * execute them in parallel. Both numbers are kept odd, and each step
+ * replaces them with |x - y| >> ctz(x - y) and min(x, y), so that ctz
+ * doesn't have to wait for the swap. Steps are branchless and x == 0 is
+ * their fixed point, so lanes that finished earlier just wait for the others.
+ * */
+template <typename T>
+IMATHLIB_CONSTEXPR_INTR void gcdBinaryInterleaved(const T* a, const T* b,
+                                                  T* out) noexcept {
+    static_assert(std::is_integral<T>::value && std::is_unsigned<T>::value,
+                  "Implementation bug - GCD must operate on unsigned");
+    constexpr int kLanes = 4;
+    constexpr int kBitsMask = sizeof(T) * 8 - 1;
+
+    T x[kLanes]{};
+    T y[kLanes]{};
+    int common_tz[kLanes]{};
+    for (int k = 0; k < kLanes; ++k) {
+        // gcd(n, 0) = gcd(0, n) = n, start such lanes already finished
+        bool finished = (a[k] == 0) | (b[k] == 0);
+        x[k] = finished ? 0 : a[k];
+        y[k] = finished ? (a[k] | b[k]) : b[k];
+        // ctz(0) is the bit length of T, masked to 0
+        common_tz[k] = detail::ctz(static_cast<T>(x[k] | y[k])) & kBitsMask;
+        x[k] >>= detail::ctz(x[k]) & kBitsMask;
+        y[k] >>= detail::ctz(y[k]) & kBitsMask;
+    }
+
+    T any_active{};
+    do {
+        any_active = 0;
+        for (int k = 0; k < kLanes; ++k) {
+            bool active = x[k] != 0;
+            bool less = x[k] < y[k];
+            T diff = static_cast<T>(x[k] - y[k]);
+            T abs_diff = less ? static_cast<T>(y[k] - x[k]) : diff;
+            T smaller = less ? x[k] : y[k];
+            y[k] = active ? smaller : y[k];
+            x[k] = active ? abs_diff >> (detail::ctz(diff) & kBitsMask) : 0;
+            any_active |= x[k];
+        }
+    } while (any_active);
+
+    for (int k = 0; k < kLanes; ++k) {
+        out[k] = y[k] << common_tz[k];
+    }
+}
+
+/**
+ * Instruction set extensions of the CPU that runs the program.
+ * All of them are false on other architectures, and without
+ * IMATHLIB_ENABLE_AVX2_DISPATCH.
+ * */
+struct CpuFeatures {
+    bool lzcnt;
+    bool bmi1;
+    bool bmi2;
+    bool avx2;
+};
+
+#if IMATHLIB_HAS_CPUID
+inline void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int values[4];
+    __cpuidex(values, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) {
+        regs[i] = static_cast<uint32_t>(values[i]);
+    }
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// XCR0 register, which tells what state the OS saves on context switches
+inline uint64_t xgetbv0() noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _xgetbv(0);
+#else
+    uint32_t lo = 0;
+    uint32_t hi = 0;
+    __asm__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return (uint64_t{hi} << 32) | lo;
+#endif
+}
+#endif  // IMATHLIB_HAS_CPUID
+
+inline CpuFeatures detectCpuFeatures() noexcept {
+    CpuFeatures features{false, false, false, false};
+#if IMATHLIB_HAS_CPUID
+    uint32_t regs[4] = {0, 0, 0, 0};
+    cpuid(0x80000000u, 0, regs);
+    if (regs[0] >= 0x80000001u) {
+        cpuid(0x80000001u, 0, regs);
+        features.lzcnt = (regs[2] >> 5 & 1) != 0;
+    }
+    cpuid(0, 0, regs);
+    if (regs[0] < 7) return features;
+    cpuid(1, 0, regs);
+    // AVX registers are usable only if the OS saves them (XCR0 bits 1, 2)
+    bool avx_enabled = (regs[2] >> 27 & 1) != 0 && (regs[2] >> 28 & 1) != 0 &&
+                       (xgetbv0() & 6) == 6;
+    cpuid(7, 0, regs);
+    features.bmi1 = (regs[1] >> 3 & 1) != 0;
+    features.bmi2 = (regs[1] >> 8 & 1) != 0;
+    features.avx2 = avx_enabled && (regs[1] >> 5 & 1) != 0;
+#endif
+    return features;
+}
+
+/**
+ * Features are detected once, during the dynamic initialization.
+ * Until then they are all false, so code running earlier takes
+ * the baseline paths, which are always correct.
+ * */
+template <typename Dummy = void>
+struct CpuDispatch {
+    static const CpuFeatures features;
+};
+
+template <typename Dummy>
+const CpuFeatures CpuDispatch<Dummy>::features = detectCpuFeatures();
+
+/**
+ * Whether the AVX2 kernels can run. Outside of -mavx2 builds they are
+ * compiled with IMATHLIB_TARGET_AVX2, which lets the code inlined into them
+ * use LZCNT, TZCNT and MULX too, so those are checked as well.
+ * */
+inline bool hasAvx2() noexcept {
+#if IMATHLIB_AVX2
+    return true;
+#else
+    const CpuFeatures& features = CpuDispatch<>::features;
+    return features.avx2 && features.bmi1 && features.bmi2 && features.lzcnt;
+#endif
+}
+
+#if IMATHLIB_AVX2_KERNELS
+/**
+ * Trailing zeroes of 4 numbers at once, any value > 63 for 0.
+ * The lowest set bit of each 32-bit half is converted to float,
+ * and its exponent is the number of trailing zeroes.
+ * */
+IMATHLIB_TARGET_AVX2
+inline __m256i ctzAvx2(__m256i n) {
+    __m256i lowest = _mm256_and_si256(
+        n, _mm256_sub_epi32(_mm256_setzero_si256(), n));
+    __m256i exponent = _mm256_srli_epi32(
+        _mm256_castps_si256(_mm256_cvtepi32_ps(lowest)), 23);
+    // 2^31 is converted to negative float, so drop the sign bit
+    exponent = _mm256_and_si256(exponent, _mm256_set1_epi32(0xFF));
+    __m256i ctz32 = _mm256_sub_epi32(exponent, _mm256_set1_epi32(127));
+    __m256i ctz_lo = _mm256_and_si256(ctz32, _mm256_set1_epi64x(0xFFFFFFFF));
+    __m256i ctz_hi = _mm256_add_epi64(_mm256_srli_epi64(ctz32, 32),
+                                      _mm256_set1_epi64x(32));
+    __m256i lo_zero = _mm256_cmpeq_epi64(
+        _mm256_and_si256(n, _mm256_set1_epi64x(0xFFFFFFFF)),
+        _mm256_setzero_si256());
+    return _mm256_blendv_epi8(ctz_lo, ctz_hi, lo_zero);
+}
+
+/**
+ * AVX2 version of gcdBinaryInterleaved for 4 pairs of 64-bit numbers.
+ * Shifts by counts > 63 give 0 in AVX2, so zeroes need no special care.
+ * */
+IMATHLIB_TARGET_AVX2
+inline __m256i gcdBinaryAvx2(__m256i a, __m256i b) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+
+    __m256i finished = _mm256_or_si256(_mm256_cmpeq_epi64(a, zero),
+                                       _mm256_cmpeq_epi64(b, zero));
+    __m256i y = _mm256_blendv_epi8(b, _mm256_or_si256(a, b), finished);
+    __m256i x = _mm256_andnot_si256(finished, a);
+    __m256i common_tz = ctzAvx2(_mm256_or_si256(x, y));
+    x = _mm256_srlv_epi64(x, ctzAvx2(x));
+    y = _mm256_srlv_epi64(y, ctzAvx2(y));
+
+    while (!_mm256_testz_si256(x, x)) {
+        __m256i active = _mm256_xor_si256(_mm256_cmpeq_epi64(x, zero),
+                                          _mm256_set1_epi64x(-1));
+        // unsigned x < y
+        __m256i less = _mm256_cmpgt_epi64(_mm256_xor_si256(y, sign),
+                                          _mm256_xor_si256(x, sign));
+        __m256i diff = _mm256_sub_epi64(x, y);
+        __m256i abs_diff = _mm256_blendv_epi8(
+            diff, _mm256_sub_epi64(zero, diff), less);
+        y = _mm256_blendv_epi8(y, x, _mm256_and_si256(active, less));
+        x = _mm256_and_si256(active,
+                             _mm256_srlv_epi64(abs_diff, ctzAvx2(diff)));
+    }
+
+    return _mm256_sllv_epi64(y, common_tz);
+}
+
+/**
+ * gcd of 64-bit arrays, 4 pairs at once. Returns how many of them were done.
+ * */
+IMATHLIB_TARGET_AVX2
+inline size_t gcdAvx2(const uint64_t* a, const uint64_t* b, size_t count,
+                      uint64_t* out) noexcept {
+    size_t vectorized = count / 4 * 4;
+    for (size_t i = 0; i < vectorized; i += 4) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                            gcdBinaryAvx2(x, y));
+    }
+    return vectorized;
+}
+#endif  // IMATHLIB_AVX2_KERNELS
+
+/**
+ * Extended Euclidean algorithm, returns {gcd, x, y} with a * x + b * y = gcd.
+ * Coefficients are calculated in unsigned arithmetic modulo 2^bits.
+ * Their final values fit in the signed type, so the result is exact,
+ * only the last, discarded pair may overflow.
+ * */
+template <typename T, typename R>
+constexpr R extendedEuclid(T a, T b) noexcept {
+    T x = 1;
+    T y = 0;
+    T next_x = 0;
+    T next_y = 1;
+    while (b != 0) {
+        T q = a / b;
+        T r = a % b;
+        a = b;
+        b = r;
+        T temp_x = static_cast<T>(x - q * next_x);
+        T temp_y = static_cast<T>(y - q * next_y);
+        x = next_x;
+        y = next_y;
+        next_x = temp_x;
+        next_y = temp_y;
+    }
+    using S = typename std::make_signed<T>::type;
+    return R{a, static_cast<S>(x), static_cast<S>(y)};
+}
+
+/**
+ * Modular inverse with the extended Euclidean algorithm, for any modulo.
+ * Returns 0 if n is not invertible.
+ * */
+template <typename T, typename R>
+constexpr T modInverseEuclid(T n, T mod) noexcept {
+    R result = extendedEuclid<T, R>(n % mod, mod);
+    if (result.gcd != 1) return 0;
+    // x is in (-mod, mod)
+    return result.x < 0 ? static_cast<T>(mod + static_cast<T>(result.x))
+                        : static_cast<T>(result.x);
+}
+
 /**
  * Pre-computed magic array for faster MR prime test of 32-bit numbers.
  * Any 32-bit number coprime to 210 is assigned a hash value,
@@ -520,22 +1087,37 @@ constexpr uint32_t bases_prime_test_u64[128] {
     54771238, 54907391
 };
 
+/**
+ * Number of bases raised to one power together by powmodMulti.
+ * Four measured twice as fast as one after another, more did not help.
+ * */
+constexpr size_t kPowmodLanes = 4;
+
+/**
+ * The end of the Miller-Rabin test of n to some base,
+ * with power = base^d mod n, where n - 1 = d * 2^s and d is odd.
+ * */
+template <typename T>
+constexpr bool isSPRPPower(T n, T power, int s) noexcept {
+    if (power == 1) return true;
+    for (int r = 0; r < s; r++) {
+        if (power == n - 1) return true;
+        power = mulmod(power, power, n);
+    }
+    return false;
+}
+
 /**
  * Miller-Rabin probabilistic test.
  * https://en.wikipedia.org/wiki/Miller%E2%80%93Rabin_primality_test
  * */
 IMATHLIB_CONSTEXPR_INTR
 bool isSPRP(uint32_t n, uint32_t base) noexcept {
+    IMATHLIB_STATS_ADD(sprp_rounds, 1);
     uint32_t d = n - 1;
     int s = ctz(d);
     d >>= s;
-    uint32_t cur = powmod(base, d, n);
-    if (cur == 1) return true;
-    for (int r = 0; r < s; r++) {
-        if (cur == n - 1) return true;
-        cur = mulmod(cur, cur, n);
-    }
-    return false;
+    return isSPRPPower(n, powmod(base, d, n), s);
 }
 
 /**
@@ -544,68 +1126,31 @@ bool isSPRP(uint32_t n, uint32_t base) noexcept {
  * */
 IMATHLIB_CONSTEXPR_X64
 bool isSPRP(uint64_t n, uint64_t base) noexcept {
+    IMATHLIB_STATS_ADD(sprp_rounds, 1);
     uint64_t d = n - 1;
     int s = ctz(d);
     d >>= s;
-    uint64_t cur = powmod(base, d, n);
-    if (cur == 1) return true;
-    for (int r = 0; r < s; r++) {
-        if (cur == n - 1) return true;
-        cur = mulmod(cur, cur, n);
-    }
-    return false;
-}
-
-constexpr uint32_t pollardRhoPoly(uint32_t x, uint32_t mod) noexcept {
-    return static_cast<uint32_t>((uint64_t{x} * x + 1) % mod);
-}
-
-/**
- * Pollard's Rho factorization algorithm
- * Returns one of the non-trivial divisors of n, or n on failure.
- * The algorithm may fail for composite numbers.
- * Returned divisor does not have to be a prime number.
- * */
-IMATHLIB_CONSTEXPR_INTR
-uint32_t pollardRhoFactorization(uint32_t n, uint32_t starting_value) noexcept {
-    uint32_t turtle = starting_value;
-    uint32_t hare = starting_value;
-    uint32_t result = 1;
-    while (result == 1) {
-        turtle = pollardRhoPoly(turtle, n);
-        hare = pollardRhoPoly(hare, n);
-        hare = pollardRhoPoly(hare, n);
-        auto diff = (turtle>hare) ? (turtle-hare) : (hare-turtle);
-        result = gcd(diff, n);
-    }
-    return result;
-}
-
-IMATHLIB_CONSTEXPR_X64
-uint64_t pollardRhoPoly(uint64_t x, uint64_t mod) noexcept {
-    auto r = mulmod(x, x, mod) + 1;
-    return r == mod ? 0 : r;
+    return isSPRPPower(n, powmod(base, d, n), s);
 }
 
 /**
- * Pollard's Rho factorization algorithm
- * Returns one of the non-trivial divisors of n, or n on failure.
- * The algorithm may fail for composite numbers.
- * Returned divisor does not have to be a prime number.
+ * Miller-Rabin tests to up to kPowmodLanes bases, which raises all of them
+ * to d at once with powmodMulti. Unlike a chain of isSPRP calls,
+ * it does not stop before the remaining bases, when one of them fails.
  * */
 IMATHLIB_CONSTEXPR_X64
-uint64_t pollardRhoFactorization(uint64_t n, uint64_t starting_value) noexcept {
-    uint64_t turtle = starting_value;
-    uint64_t hare = starting_value;
-    uint64_t result = 1;
-    while (result == 1) {
-        turtle = pollardRhoPoly(turtle, n);
-        hare = pollardRhoPoly(hare, n);
-        hare = pollardRhoPoly(hare, n);
-        auto diff = (turtle>hare) ? (turtle-hare) : (hare-turtle);
-        result = gcd(diff, n);
+bool isSPRP(uint64_t n, const uint64_t* bases, size_t count) noexcept {
+    IMATHLIB_ASSERT(count <= kPowmodLanes);
+    IMATHLIB_STATS_ADD(sprp_rounds, count);
+    uint64_t d = n - 1;
+    int s = ctz(d);
+    d >>= s;
+    uint64_t powers[kPowmodLanes] = {};
+    powmodMulti(bases, count, d, n, powers);
+    for (size_t i = 0; i < count; ++i) {
+        if (!isSPRPPower(n, powers[i], s)) return false;
     }
-    return result;
+    return true;
 }
 
 constexpr u128 mul64x64Fallback(uint64_t a, uint64_t b) noexcept {
@@ -643,7 +1188,7 @@ constexpr u128 mul64x64Fallback(uint64_t a, uint64_t b) noexcept {
 }
 
 IMATHLIB_CONSTEXPR_X64 u128 mul64x64(uint64_t a, uint64_t b) noexcept {
-#if defined(__SIZEOF_INT128__)
+#if IMATHLIB_HAS_INT128
     __uint128_t result = (__uint128_t{a} * b);
     return u128{static_cast<uint64_t>(result >> 64),
                 static_cast<uint64_t>(result & static_cast<uint64_t>(-1))};
@@ -651,7 +1196,8 @@ IMATHLIB_CONSTEXPR_X64 u128 mul64x64(uint64_t a, uint64_t b) noexcept {
     if (IMATHLIB_IS_CONSTEVAL) {
         return mul64x64Fallback(a, b);
     }
-#if defined(_M_X64) || defined(_M_ARM64) || defined(_M_IA64)
+#if (defined(_M_X64) || defined(_M_ARM64) || defined(_M_IA64)) && \
+    !IMATHLIB_FORCE_FALLBACK
     u128 result{};
     result.lo = _umul128(a, b, &result.hi);
     return result;
@@ -705,38 +1251,91 @@ IMATHLIB_CONSTEXPR_INTR uint64_t mod128by64Fallback(const u128 n, uint64_t mod)
     return higher_bits;
 }
 
-IMATHLIB_CONSTEXPR_X64 uint64_t mod128by64(const u128 n, uint64_t mod) {
-    IMATHLIB_ASSUME(0 < n.hi);
+/**
+ * Calculates the reciprocal v = floor((2^128 - 1) / d) - 2^64
+ * of a normalized divisor d (with the highest bit set),
+ * using only multiplications and a single 32-bit division.
+ * Algorithm 3 from N. Möller, T. Granlund
+ * "Improved division by invariant integers"
+ * https://gmplib.org/~tege/division-paper.pdf
+ * */
+IMATHLIB_CONSTEXPR_X64 uint64_t reciprocal64(uint64_t d) noexcept {
+    IMATHLIB_ASSUME(d >> 63);
+    uint64_t d0 = d & 1;
+    uint64_t d9 = d >> 55;
+    uint64_t d40 = (d >> 24) + 1;
+    uint64_t d63 = (d >> 1) + d0;
+    // The paper uses a 256-entry lookup table here,
+    // but a 32-bit division is cheap on any 64-bit architecture
+    uint64_t v0 = ((1u << 19) - 3 * (1u << 8)) / static_cast<uint32_t>(d9);
+    uint64_t v1 = (v0 << 11) - ((v0 * v0 * d40) >> 40) - 1;
+    uint64_t v2 = (v1 << 13) + ((v1 * ((1ull << 60) - v1 * d40)) >> 47);
+IMATHLIB_MSC_WARNING(4146)
+    uint64_t e = ((v2 >> 1) & (-d0)) - v2 * d63;
+    uint64_t v3 = (mul64x64(v2, e).hi >> 1) + (v2 << 31);
+    // v4 = v3 - hi((v3 + 2^64 + 1) * d)
+    u128 p = mul64x64(v3, d);
+    p.lo += d;
+    p.hi += d + (p.lo < d);
+    return v3 - p.hi;
+}
+
+/**
+ * 128 by 64 bit modulo with a normalized divisor d and its reciprocal v.
+ * Algorithm 4 from the paper above. It needs only multiplications,
+ * so it is preferred on architectures without 128 by 64 bit division
+ * instruction, like ARM64 (UMULH).
+ * */
+IMATHLIB_CONSTEXPR_X64
+uint64_t mod128by64Normalized(const u128 n, uint64_t d, uint64_t v) noexcept {
+    IMATHLIB_ASSUME(d >> 63);
+    IMATHLIB_ASSUME(n.hi < d);
+    u128 q = mul64x64(v, n.hi);
+    q.lo += n.lo;
+    q.hi += n.hi + 1 + (q.lo < n.lo);
+    uint64_t r = n.lo - q.hi * d;
+    // both branches are usually compiled to CMOVs
+    if (r > q.lo) r += d;
+    if (r >= d) r -= d;
+    return r;
+}
+
+IMATHLIB_CONSTEXPR_X64
+uint64_t mod128by64Reciprocal(const u128 n, uint64_t mod) noexcept {
     IMATHLIB_ASSUME(0 < mod);
     IMATHLIB_ASSUME(n.hi < mod);
-
-// We don't really want to use modulo on builtin u128,
-// and x86_64 assembly is prefferable.
-// We don't know if builtin optimizes for empty high bits in mod,
-// and call to it likely won't be inlined.
-// However, assembly is not available in constexpr context and having
-// constexpr in C++14 for everything is cool.
-#if defined(__SIZEOF_INT128__)
-        __uint128_t p{n.hi};
-        p <<= 64;
-        p |= n.lo;
-        return static_cast<uint64_t>(p % mod);
-#else
-    if (IMATHLIB_IS_CONSTEVAL) {
-        return mod128by64Fallback(n, mod);
+    int shift = detail::clz(mod);
+    uint64_t d = mod << shift;
+    u128 u{n.hi << shift, n.lo << shift};
+    if (shift != 0) {
+        // to avoid Undefined Behaviour with shift by 64
+        u.hi |= n.lo >> (64 - shift);
     }
+    return mod128by64Normalized(u, d, reciprocal64(d)) >> shift;
+}
 
-#if __x86_64__
+/**
+ * 128 by 64 bit modulo using the fastest way available on the platform.
+ * Not available in constexpr context, use mod128by64 instead.
+ * */
+inline uint64_t mod128by64Native(const u128 n, uint64_t mod) noexcept {
+    IMATHLIB_ASSUME(0 < mod);
+    IMATHLIB_ASSUME(n.hi < mod);
+#if IMATHLIB_FORCE_FALLBACK
+    return mod128by64Fallback(n, mod);
+#elif defined(__x86_64__)
     // divq instruction
     // performs 128/64 bit division
     // rdx:rax / passed register
     // reminder stored in rdx, quotient (ignored) in rax
     // IMPORTANT - quotient must fit into 64bit register,
     // or else DE is raised (like with division by 0)
+    uint64_t quotient;
     uint64_t result;
     __asm__("divq    %[v]"
-            : "=d"(result)
+            : "=a"(quotient), "=d"(result)
             : [ v ] "r"(mod), "d"(n.hi), "a"(n.lo));
+    (void)quotient;
     return result;
 #elif defined(_M_X64)
     // inline assembly not available in MSVC x64,
@@ -744,543 +1343,3603 @@ IMATHLIB_CONSTEXPR_X64 uint64_t mod128by64(const u128 n, uint64_t mod) {
     uint64_t result;
     (void)_udiv128(n.hi, n.lo, mod, &result);
     return result;
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    // There is no 128 by 64 bit division on ARM64,
+    // but high bits of multiplication (UMULH) are cheap
+    return mod128by64Reciprocal(n, mod);
 #else
     return mod128by64Fallback(n, mod);
-#endif  // __x86_64__ defined(_M_X64)
-#endif  // defined(__SIZEOF_INT128__)
+#endif  // defined(__x86_64__)
+}
+
+IMATHLIB_CONSTEXPR_X64 uint64_t mod128by64(const u128 n, uint64_t mod) {
+    IMATHLIB_ASSUME(0 < n.hi);
+    IMATHLIB_ASSUME(0 < mod);
+    IMATHLIB_ASSUME(n.hi < mod);
+
+// We don't really want to use modulo on builtin u128,
+// GCC and Clang compile it to a __umodti3 call, which is not inlined
+// and doesn't optimize for empty high bits in mod.
+// However, assembly is not available in constexpr context and having
+// constexpr in C++14 for everything is cool, so builtin u128 is used
+// whenever we can't tell if we are constant evaluated.
+#if IMATHLIB_HAS_INT128 && IMATHLIB_FAST_LIBRARY_MODULO
+#if IMATHLIB_HAS_BUILTIN_CONSTEVAL && \
+    (defined(__x86_64__) || defined(__aarch64__))
+    if (!__builtin_is_constant_evaluated()) {
+        return mod128by64Native(n, mod);
+    }
+#endif
+    __uint128_t p{n.hi};
+    p <<= 64;
+    p |= n.lo;
+    return static_cast<uint64_t>(p % mod);
+#else
+    if (IMATHLIB_IS_CONSTEVAL) {
+        return mod128by64Fallback(n, mod);
+    }
+    return mod128by64Native(n, mod);
+#endif  // IMATHLIB_HAS_INT128 && IMATHLIB_FAST_LIBRARY_MODULO
 }
 
 /**
- * A simple binary-search constexpr implementation of square root for integers.
- * Used by isPerfectSquare to make it constexpr for C++20
+ * Schoolbook division, one bit of the quotient at a time, n.hi < d.
+ * Plain constexpr, for constants which must be known at compile time.
  * */
-constexpr uint32_t isqrt(uint32_t n) noexcept {
-    uint32_t left = 0;
-    uint32_t right = detail::min(uint32_t{UINT16_MAX}, n);
-    while (left != right) {
-        uint32_t mid = (left + right) / 2; // no risk of overflow
-        if (mid * mid == n) {
-            return mid;
-        } else if (mid * mid < n) {
-            left = mid + 1;
-        } else {
-            right = mid - 1;
+constexpr uint64_t div128by64Schoolbook(const u128 n, uint64_t d) noexcept {
+    uint64_t remainder = n.hi;
+    uint64_t lower_bits = n.lo;
+    uint64_t quotient = 0;
+    for (int i = 0; i < 64; ++i) {
+        bool carry = (remainder >> 63) != 0;
+        remainder = (remainder << 1) | (lower_bits >> 63);
+        lower_bits <<= 1;
+        quotient <<= 1;
+        if (carry || remainder >= d) {
+            remainder -= d;
+            quotient |= 1;
         }
     }
-    return left;
+    return quotient;
 }
 
 /**
- * A simple binary-search constexpr implementation of square root for integers.
- * Used by isPerfectSquare to make it constexpr for C++20
+ * Quotient of 128 by 64 bit division, n.hi < d, so that it fits.
+ * Meant for precomputations, there is no fast path for small numbers.
  * */
-constexpr uint64_t isqrt(uint64_t n) noexcept {
-    uint64_t left = 0;
-    uint64_t right = detail::min(uint64_t{UINT32_MAX}, n);
-    while (left != right) {
-        uint64_t mid = (left + right) / 2; // no risk of overflow
-        if (mid * mid == n) {
-            return mid;
-        } else if (mid * mid < n) {
-            left = mid + 1;
-        } else {
-            right = mid - 1;
-        }
+IMATHLIB_CONSTEXPR_X64 uint64_t div128by64(const u128 n, uint64_t d) {
+    IMATHLIB_ASSUME(0 < d);
+    IMATHLIB_ASSUME(n.hi < d);
+#if IMATHLIB_HAS_INT128
+    __uint128_t p{n.hi};
+    p <<= 64;
+    p |= n.lo;
+    return static_cast<uint64_t>(p / d);
+#else
+#if defined(_M_X64) && !IMATHLIB_FORCE_FALLBACK
+    if (!IMATHLIB_IS_CONSTEVAL) {
+        uint64_t remainder;
+        return _udiv128(n.hi, n.lo, d, &remainder);
     }
-    return left;
+#endif
+    return div128by64Schoolbook(n, d);
+#endif  // IMATHLIB_HAS_INT128
 }
 
-} // namespace detail
+/**
+ * High half of the product, the core of division by invariant integers.
+ * */
+constexpr uint32_t mulHigh(uint32_t a, uint32_t b) noexcept {
+    return static_cast<uint32_t>((uint64_t{a} * b) >> 32);
+}
+IMATHLIB_CONSTEXPR_X64 uint64_t mulHigh(uint64_t a, uint64_t b) noexcept {
+    return mul64x64(a, b).hi;
+}
+
+/**
+ * floor(hi * 2^bits / d) for hi < d.
+ * */
+constexpr uint32_t wideQuotient(uint32_t hi, uint32_t d) noexcept {
+    return static_cast<uint32_t>((uint64_t{hi} << 32) / d);
+}
+IMATHLIB_CONSTEXPR_X64 uint64_t wideQuotient(uint64_t hi, uint64_t d) noexcept {
+    return div128by64(u128{hi, 0}, d);
+}
+
+/**
+ * Inverse of an odd number modulo 2^bits with Newton's iteration.
+ * n is its own inverse modulo 8, and each step doubles the correct bits.
+ * */
+template <typename T>
+constexpr T inverseModPow2(T n) noexcept {
+    IMATHLIB_ASSERT(n & 1);
+    T inverse = n;
+    for (size_t bits = 3; bits < sizeof(T) * 8; bits *= 2) {
+        inverse = static_cast<T>(inverse * static_cast<T>(2 - n * inverse));
+    }
+    return inverse;
+}
+
+/**
+ * Odd prime p with p^-1 mod 2^bits and floor((2^bits - 1) / p).
+ * n is divisible by p exactly when n * p^-1 mod 2^bits <= limit,
+ * and then n * p^-1 is the quotient, so no division is needed.
+ * */
+template <typename T>
+struct TrialDivisor {
+    T prime;
+    T inverse;
+    T limit;
+};
 
+/**
+ * The first SIZE odd primes as TrialDivisors, in one contiguous array,
+ * so that trial division streams through it.
+ * */
 template <size_t SIZE, typename T>
-class PrimeArray {
+class TrialDivisionTable {
 public:
-    static_assert(std::is_integral<T>::value, "PrimeArray must contain integers");
-    static_assert(SIZE > 0, "Empty PrimeArray is not allowed");
-
-    constexpr
-    PrimeArray() noexcept : array{} {
+    constexpr TrialDivisionTable() noexcept : divisors_{} {
         constexpr const size_t sieve_size = getSieveSize();
-        bool sieve[sieve_size]{}; // true if is composite
-        array[0] = 2;
-        size_t filled = 1;
-        size_t next_prime = 1;
-        while (filled < SIZE) {
-            do next_prime += 2; while(sieve[next_prime / 2]);
-            array[filled++] = static_cast<T>(next_prime);
-            if (next_prime * next_prime > next_prime) // protect from overflow
-            for (size_t i = next_prime * next_prime;
-                    i / 2 < sieve_size;
-                    i += 2 * next_prime)
-                sieve[i / 2] = true;
+        bool sieve[sieve_size]{};  // sieve[i] is true if 2 * i + 1 is composite
+        size_t count = 0;
+        for (size_t i = 1; count < SIZE; ++i) {
+            if (sieve[i]) continue;
+            T prime = static_cast<T>(2 * i + 1);
+            divisors_[count].prime = prime;
+            divisors_[count].inverse = inverseModPow2(prime);
+            divisors_[count].limit = static_cast<T>(-1) / prime;
+            ++count;
+            for (size_t j = size_t{prime} * prime / 2; j < sieve_size;
+                 j += prime) {
+                sieve[j] = true;
+            }
         }
     }
 
     constexpr size_t size() const noexcept {
         return SIZE;
     }
-    constexpr const T* begin() const noexcept {
-        return array;
-    }
-    constexpr const T* end() const noexcept {
-        return array + SIZE;
-    }
-    constexpr const T& operator[](size_t idx) const {
-        return array[idx];
+    constexpr const TrialDivisor<T>* begin() const noexcept {
+        return divisors_;
     }
-    constexpr const T& back() const {
-        return array[SIZE - 1];
+    constexpr const TrialDivisor<T>* end() const noexcept {
+        return divisors_ + SIZE;
     }
 
 private:
-    T array[SIZE];
+    TrialDivisor<T> divisors_[SIZE];
+
+    // Odd numbers up to about 1.5 * SIZE * log2(SIZE), enough to hold
+    // SIZE odd primes, as the n-th prime is below n * (ln n + ln ln n)
     constexpr static size_t getSieveSize() noexcept {
-        size_t result = sizeof(size_t) * 8
-                        - detail::clzFallback(SIZE)
-                        + 2;
-        return result * 3 / 4 * SIZE;
+        size_t bits = sizeof(size_t) * 8 - detail::clzFallback(SIZE);
+        return (bits + 2) * 3 / 4 * SIZE + 2;
     }
 };
 
-constexpr PrimeArray<64, uint16_t> kSmallPrimes;
+// Odd primes up to 8167, chosen with factorize benchmarks. Trial division
+// by all of them costs about as much as a single Pollard's rho run
+// on a small cofactor, and the 64-bit table still fits in L1 cache
+constexpr size_t kTrialDivisionPrimes = 1024;
+constexpr TrialDivisionTable<kTrialDivisionPrimes, uint32_t> kTrialDivisorsU32;
+constexpr TrialDivisionTable<kTrialDivisionPrimes, uint64_t> kTrialDivisorsU64;
 
-IMATHLIB_CONSTEXPR_INTR bool isPrime(uint32_t n) noexcept {
-    if (n == 2 || n == 3 || n == 5 || n == 7) return true;
-    if (n % 2 == 0 || n % 3 == 0 || n % 5 == 0 || n % 7 == 0) return false;
-    if (n < 121) return (n > 1);
-    uint64_t h = n;  // important - 64 bits
-    h = ((h >> 16) ^ h) * 0x979bc64f;
-    h = ((h >> 16) ^ h) * 0x979bc64f;
-    h = ((h >> 16) ^ h) & 255;
-    return detail::isSPRP(n, detail::bases_prime_test_u32[h]);
+/**
+ * x * 2^-k modulo odd mod, for x < mod, with mod_inverse = mod^-1 mod 2^32.
+ * Like in Montgomery reduction, t * mod with the same low bits as x
+ * is subtracted from x, so that the difference is divisible by 2^bits.
+ * */
+constexpr uint32_t divPow2Mod(uint32_t x, int k, uint32_t mod,
+                              uint32_t mod_inverse) noexcept {
+    while (k > 0) {
+        int bits = detail::min(k, 32);
+        uint64_t mask = (uint64_t{1} << bits) - 1;
+        uint64_t t = (x * mod_inverse) & mask;
+        uint32_t x_shifted = static_cast<uint32_t>(uint64_t{x} >> bits);
+        uint32_t tm_shifted = static_cast<uint32_t>((t * mod) >> bits);
+        x = x_shifted - tm_shifted + (x_shifted < tm_shifted ? mod : 0);
+        k -= bits;
+    }
+    return x;
+}
+
+/**
+ * x * 2^-k modulo odd mod, for x < mod, with mod_inverse = mod^-1 mod 2^64.
+ * */
+IMATHLIB_CONSTEXPR_X64 uint64_t divPow2Mod(uint64_t x, int k, uint64_t mod,
+                                           uint64_t mod_inverse) noexcept {
+    while (k > 0) {
+        int bits = detail::min(k, 63);
+        uint64_t t = (x * mod_inverse) & ((uint64_t{1} << bits) - 1);
+        u128 tm = mul64x64(t, mod);
+        uint64_t x_shifted = x >> bits;
+        uint64_t tm_shifted = (tm.hi << (64 - bits)) | (tm.lo >> bits);
+        x = x_shifted - tm_shifted + (x_shifted < tm_shifted ? mod : 0);
+        k -= bits;
+    }
+    return x;
+}
+
+/**
+ * a * b * 2^-32 modulo odd mod, for a * b < mod * 2^32,
+ * with mod_inverse = mod^-1 mod 2^32 (Montgomery multiplication).
+ * */
+constexpr uint32_t montgomeryMul(uint32_t a, uint32_t b, uint32_t mod,
+                                 uint32_t mod_inverse) noexcept {
+    uint64_t x = uint64_t{a} * b;
+    uint32_t t = static_cast<uint32_t>(x) * mod_inverse;
+    uint32_t x_hi = static_cast<uint32_t>(x >> 32);
+    uint32_t tm_hi = static_cast<uint32_t>((uint64_t{t} * mod) >> 32);
+    return x_hi - tm_hi + (x_hi < tm_hi ? mod : 0);
+}
+
+/**
+ * a * b * 2^-64 modulo odd mod, for a * b < mod * 2^64,
+ * with mod_inverse = mod^-1 mod 2^64 (Montgomery multiplication).
+ * */
+IMATHLIB_CONSTEXPR_X64 uint64_t montgomeryMul(uint64_t a, uint64_t b,
+                                              uint64_t mod,
+                                              uint64_t mod_inverse) noexcept {
+    u128 x = mul64x64(a, b);
+    uint64_t t = x.lo * mod_inverse;
+    uint64_t tm_hi = mul64x64(t, mod).hi;
+    return x.hi - tm_hi + (x.hi < tm_hi ? mod : 0);
+}
+
+/**
+ * n * 2^bits mod mod, the Montgomery form of n.
+ * */
+constexpr uint32_t toMontgomery(uint32_t n, uint32_t mod) noexcept {
+    return static_cast<uint32_t>((uint64_t{n} << 32) % mod);
+}
+
+IMATHLIB_CONSTEXPR_X64 uint64_t toMontgomery(uint64_t n,
+                                             uint64_t mod) noexcept {
+    // 2^64 mod mod, calculated as (2^64 - mod) mod mod
+    return mulmod(n, (0 - mod) % mod, mod);
+}
+
+/**
+ * n^pow modulo odd mod, right to left in Montgomery form.
+ * The result is multiplied by n^(2^i) or by one, selected without a branch:
+ * the squarings are a dependency chain of their own, and the other
+ * multiplications fit in between, but a mispredicted bit stalls both.
+ * */
+template <typename T>
+constexpr T powmodMontgomery(T n, T pow, T mod) noexcept {
+    const T mod_inverse = inverseModPow2(mod);
+    const T one = toMontgomery(T{1}, mod);
+    T base = toMontgomery(static_cast<T>(n % mod), mod);
+    T result = one;
+    while (pow) {
+        result = montgomeryMul(result, (pow & 1) ? base : one, mod,
+                               mod_inverse);
+        base = montgomeryMul(base, base, mod, mod_inverse);
+        pow >>= 1;
+    }
+    return montgomeryMul(result, T{1}, mod, mod_inverse);
+}
+
+/**
+ * Exponents from this many bits pay for the conversions
+ * to and from Montgomery form.
+ * */
+constexpr int kPowmodMontgomeryBits = 8;
+
+/**
+ * Multiplication in a fixed ring, for the chains of powmod<E>.
+ * */
+template <typename T>
+struct MulModBy {
+    T mod;
+
+    constexpr T operator()(T a, T b) const noexcept {
+        return mulmod(a, b, mod);
+    }
+};
+
+template <typename T>
+struct MontgomeryMulBy {
+    T mod;
+    T mod_inverse;
+
+    constexpr T operator()(T a, T b) const noexcept {
+        return montgomeryMul(a, b, mod, mod_inverse);
+    }
+};
+
+/**
+ * result * base^E, unrolled at compile time: one squaring per bit of E,
+ * and a multiplication only for the bits which are set.
+ * This is right-to-left square and multiply, not a shortest addition
+ * chain. Shorter chains, like windows or NAF, save multiplications but
+ * run left to right, with every step waiting for the one before. Here the
+ * multiplications by the powers of base overlap with the squarings,
+ * and left-to-right windows measured no faster.
+ * */
+template <uint64_t E>
+struct PowChain {
+    template <typename T, typename Mul>
+    static constexpr T apply(T result, T base, const Mul& mul) noexcept {
+        return PowChain<E / 2>::apply((E & 1) ? mul(result, base) : result,
+                                      (E / 2) ? mul(base, base) : base, mul);
+    }
+};
+
+template <>
+struct PowChain<0> {
+    template <typename T, typename Mul>
+    static constexpr T apply(T result, T, const Mul&) noexcept {
+        return result;
+    }
+};
+
+/**
+ * n^E modulo mod, for n < mod.
+ * */
+template <uint64_t E, typename T>
+constexpr T powmodChain(T n, T mod) noexcept {
+    if (IMATHLIB_KNOWN_CONSTANT(mod) && (mod >> 31 >> 1) == 0 &&
+        (E >> 31 >> 1) == 0) {
+        // % by a known modulus is a multiplication, and with E known too
+        // the branches of the loop are free - it measured faster than
+        // the unrolled chain
+        return powmod(n, static_cast<T>(E), mod);
+    }
+    if ((E >> kPowmodMontgomeryBits) == 0 || (mod & 1) == 0) {
+        return PowChain<E>::apply(static_cast<T>(1 % mod), n,
+                                  MulModBy<T>{mod});
+    }
+    MontgomeryMulBy<T> mul{mod, inverseModPow2(mod)};
+    T result = PowChain<E>::apply(toMontgomery(T{1}, mod),
+                                  toMontgomery(n, mod), mul);
+    return mul(result, T{1});
+}
+
+/**
+ * bases[i]^pow modulo odd mod, for up to kPowmodLanes bases.
+ * As in powmodMontgomery, but the chains of all bases advance together,
+ * so the multiplier works on one base while it waits for another.
+ * */
+template <typename T>
+constexpr void powmodMontgomeryLanes(const T* bases, size_t count, T pow,
+                                     T mod, T* out) noexcept {
+    const T mod_inverse = inverseModPow2(mod);
+    const T one = toMontgomery(T{1}, mod);
+    // Montgomery form of any base < 2^bits, as base * 2^bits * 2^bits
+    // fits the product which montgomeryMul reduces
+    const T one_squared = toMontgomery(one, mod);
+    T base[kPowmodLanes] = {};
+    T result[kPowmodLanes] = {};
+    for (size_t i = 0; i < count; ++i) {
+        base[i] = montgomeryMul(bases[i], one_squared, mod, mod_inverse);
+        result[i] = one;
+    }
+    while (pow) {
+        for (size_t i = 0; i < count; ++i) {
+            result[i] = montgomeryMul(result[i], (pow & 1) ? base[i] : one,
+                                      mod, mod_inverse);
+            base[i] = montgomeryMul(base[i], base[i], mod, mod_inverse);
+        }
+        pow >>= 1;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = montgomeryMul(result[i], T{1}, mod, mod_inverse);
+    }
+}
+
+/**
+ * a^x * b^y modulo odd mod. Both powers are computed right to left
+ * at the same time, four independent chains of multiplications.
+ * */
+template <typename T>
+constexpr T powmod2Montgomery(T a, T x, T b, T y, T mod) noexcept {
+    const T mod_inverse = inverseModPow2(mod);
+    const T one = toMontgomery(T{1}, mod);
+    const T one_squared = toMontgomery(one, mod);
+    T a_power = montgomeryMul(a, one_squared, mod, mod_inverse);
+    T b_power = montgomeryMul(b, one_squared, mod, mod_inverse);
+    T a_result = one;
+    T b_result = one;
+    while (x | y) {
+        a_result = montgomeryMul(a_result, (x & 1) ? a_power : one, mod,
+                                 mod_inverse);
+        b_result = montgomeryMul(b_result, (y & 1) ? b_power : one, mod,
+                                 mod_inverse);
+        a_power = montgomeryMul(a_power, a_power, mod, mod_inverse);
+        b_power = montgomeryMul(b_power, b_power, mod, mod_inverse);
+        x >>= 1;
+        y >>= 1;
+    }
+    // (a^x * 2^bits) * (b^y * 2^bits) * 2^-bits, and then out of the form
+    return montgomeryMul(montgomeryMul(a_result, b_result, mod, mod_inverse),
+                         T{1}, mod, mod_inverse);
+}
+
+/**
+ * 2^k mod m by doubling, for the compile-time constants of ModInt.
+ * */
+constexpr uint64_t pow2ModSlow(int k, uint64_t m) noexcept {
+    uint64_t result = 1 % m;
+    for (int i = 0; i < k; ++i) {
+        result = result >= m - result ? result - (m - result) : result + result;
+    }
+    return result;
+}
+
+/**
+ * a * b mod 2^k - 1, for a, b < 2^k - 1 and 2 <= k <= 63.
+ * 2^k = 1 modulo 2^k - 1, so the bits of the product above k are added
+ * to the lower ones, and the sum is below 2 * (2^k - 1).
+ * */
+IMATHLIB_CONSTEXPR_X64 uint64_t mulmodMersenne(uint64_t a, uint64_t b,
+                                               int k) noexcept {
+    uint64_t mod = (uint64_t{1} << k) - 1;
+    u128 x = mul64x64(a, b);
+    uint64_t r = (x.lo & mod) + ((x.lo >> k) | (x.hi << (64 - k)));
+    return r >= mod ? r - mod : r;
+}
+
+/**
+ * a * b mod 2^64 - c, for any a and b, and 0 < c < 2^32.
+ * 2^64 = c modulo 2^64 - c, so the high word is multiplied by c and added
+ * to the low one. That sum has up to 97 bits and is folded once more.
+ * */
+IMATHLIB_CONSTEXPR_X64 uint64_t mulmodPseudoMersenne(uint64_t a, uint64_t b,
+                                                     uint64_t c) noexcept {
+    uint64_t mod = 0 - c;
+    u128 x = mul64x64(a, b);
+    u128 folded = mul64x64(x.hi, c);
+    uint64_t r = x.lo + folded.lo;
+    // folded.hi < c, so high * c < 2^64
+    uint64_t high = folded.hi + (r < x.lo);
+    uint64_t sum = r + high * c;
+    if (sum < r) {
+        // sum < high * c, adding c can't overflow again
+        sum += c;
+    }
+    return sum >= mod ? sum - mod : sum;
+}
+
+/**
+ * Reduction used by ModInt<M>, the first of the forms that M matches.
+ * */
+enum class ModIntReduction {
+    kPowerOfTwo,      // M = 2^k, a mask
+    kMersenne,        // M = 2^k - 1, k < 64
+    kPseudoMersenne,  // M = 2^64 - c, c < 2^32
+    kMontgomery,      // odd M >= 2^32, values are kept in Montgomery form
+    kBarrett          // the rest, with a reciprocal of M
+};
+
+constexpr ModIntReduction modIntReduction(uint64_t m) noexcept {
+    return (m & (m - 1)) == 0                 ? ModIntReduction::kPowerOfTwo
+           : (m & (m + 1)) == 0 && m >> 63 == 0 ? ModIntReduction::kMersenne
+           : (0 - m) >> 32 == 0              ? ModIntReduction::kPseudoMersenne
+           : (m & 1) != 0 && m >> 32 != 0    ? ModIntReduction::kMontgomery
+                                             : ModIntReduction::kBarrett;
+}
+
+/**
+ * x * x * 2^-bits + c modulo odd n, the polynomial of pollardRhoBrent.
+ * */
+template <typename T>
+IMATHLIB_CONSTEXPR_X64 T pollardRhoBrentPoly(T x, T c, T n,
+                                             T n_inverse) noexcept {
+    T square = montgomeryMul(x, x, n, n_inverse);
+    return square >= n - c ? square - (n - c) : square + c;
+}
+
+/**
+ * Limits of pollardRhoBrent. spend(steps) is called before every batch
+ * of steps, and the walk stops if it returns false.
+ * */
+struct RhoNoLimit {
+    constexpr bool spend(uint64_t) const noexcept {
+        return true;
+    }
+};
+
+struct RhoIterationLimit {
+    uint64_t iterations_left;
+
+    constexpr bool spend(uint64_t steps) noexcept {
+        if (steps > iterations_left) {
+            iterations_left = 0;
+            return false;
+        }
+        iterations_left -= steps;
+        return true;
+    }
+};
+
+struct RhoDeadline {
+    std::chrono::steady_clock::time_point deadline;
+
+    bool spend(uint64_t) const noexcept {
+        return std::chrono::steady_clock::now() < deadline;
+    }
+};
+
+#if IMATHLIB_ENABLE_THREADS
+struct RhoCancelFlag {
+    const std::atomic<bool>* cancelled;
+
+    bool spend(uint64_t) const noexcept {
+        return !cancelled->load(std::memory_order_relaxed);
+    }
+};
+
+/**
+ * Not a limit, but a request to race walks on that many threads,
+ * for divisors not found in sequential_steps on the calling thread.
+ * */
+struct RhoRace {
+    unsigned threads;
+    uint64_t sequential_steps;
+};
+#endif
+
+/**
+ * Pollard's Rho factorization algorithm with Brent's cycle detection,
+ * for an odd n and 0 < c < n.
+ * Returns one of the non-trivial divisors of n, n on failure,
+ * or 1 if the limit stopped it first.
+ *
+ * Instead of a gcd per step, differences are multiplied together
+ * and the gcd of the product is taken once per kBatch steps, going
+ * back one batch if it hit n. Multiplications are Montgomery's,
+ * as a factor of 2^-bits changes neither gcds nor the pseudo-random
+ * sequence quality, so there is no division at all. That makes it the
+ * cheapest choice in constant evaluation, where mulmod falls back
+ * to bit-by-bit reduction.
+ * */
+template <typename T, typename Limit>
+IMATHLIB_CONSTEXPR_X64 T pollardRhoBrent(T n, T c, Limit& limit) noexcept {
+    IMATHLIB_ASSERT(n & 1);
+    IMATHLIB_ASSERT(0 < c && c < n);
+    IMATHLIB_STATS_ADD(rho_calls, 1);
+    const size_t kBatch = 128;
+    const T n_inverse = inverseModPow2(n);
+
+    T x = 0;
+    T y = 0;
+    T saved_y = 0;
+    T product = toMontgomery(T{1}, n);
+    T divisor = 1;
+    for (size_t range = 1; divisor == 1; range *= 2) {
+        x = y;
+        for (size_t done = 0; done < range; done += kBatch) {
+            size_t steps = detail::min(kBatch, range - done);
+            if (!limit.spend(steps)) return 1;
+            for (size_t i = 0; i < steps; ++i) {
+                y = pollardRhoBrentPoly(y, c, n, n_inverse);
+            }
+            IMATHLIB_STATS_ADD(rho_iterations, steps);
+        }
+        for (size_t done = 0; done < range && divisor == 1; done += kBatch) {
+            saved_y = y;
+            size_t steps = detail::min(kBatch, range - done);
+            if (!limit.spend(steps)) return 1;
+            for (size_t i = 0; i < steps; ++i) {
+                y = pollardRhoBrentPoly(y, c, n, n_inverse);
+                T diff = x > y ? x - y : y - x;
+                product = montgomeryMul(product, diff, n, n_inverse);
+            }
+            divisor = gcd(product, n);
+            IMATHLIB_STATS_ADD(rho_iterations, steps);
+            IMATHLIB_STATS_ADD(gcd_calls, 1);
+        }
+    }
+    if (divisor == n) {
+        do {
+            saved_y = pollardRhoBrentPoly(saved_y, c, n, n_inverse);
+            divisor = gcd(x > saved_y ? x - saved_y : saved_y - x, n);
+            IMATHLIB_STATS_ADD(rho_iterations, 1);
+            IMATHLIB_STATS_ADD(gcd_calls, 1);
+        } while (divisor == 1);
+    }
+    return divisor;
+}
+
+template <typename T>
+IMATHLIB_CONSTEXPR_X64 T pollardRhoBrent(T n, T c) noexcept {
+    RhoNoLimit limit{};
+    return pollardRhoBrent(n, c, limit);
+}
+
+/**
+ * A non-trivial divisor of odd composite n, found by pollardRhoBrent
+ * retried with the next polynomials until it succeeds,
+ * or 1 if the limit stopped it first.
+ * */
+template <typename T, typename Limit>
+IMATHLIB_CONSTEXPR_X64 T rhoDivisor(T n, T& polynomial_constant,
+                                    Limit& limit) noexcept {
+    T f = 0;
+    do {
+        f = pollardRhoBrent(n, polynomial_constant++, limit);
+        IMATHLIB_STATS_ADD(rho_retries, f == n ? 1 : 0);
+    } while (f == n);
+    return f;
+}
+
+#if IMATHLIB_ENABLE_THREADS
+/**
+ * Walks with polynomial constants c, c + threads, c + 2 * threads, ...
+ * run on each thread, and the first divisor found cancels all of them.
+ * Walks are independent, so the time is the minimum of their times,
+ * which mostly cuts the long tail of unlucky polynomials.
+ *
+ * Threads are started for each race rather than kept in a pool: a race
+ * follows sequential_steps of rho, much longer than starting a thread,
+ * and a header-only library has no good owner for idle threads.
+ * If a thread can't be started, its walk runs on the calling thread
+ * after the others, which is usually after they found a divisor.
+ * If the threads can't even be allocated, rho goes on single-threaded.
+ * */
+inline uint64_t rhoDivisor(uint64_t n, uint64_t& polynomial_constant,
+                           RhoRace& race) noexcept {
+    if (race.threads <= 1) {
+        RhoNoLimit no_limit{};
+        return rhoDivisor(n, polynomial_constant, no_limit);
+    }
+    RhoIterationLimit sequential{race.sequential_steps};
+    uint64_t f = rhoDivisor(n, polynomial_constant, sequential);
+    if (f != 1) return f;
+
+    const uint64_t first_constant = polynomial_constant;
+    const unsigned threads = race.threads;
+    std::atomic<bool> found{false};
+    std::atomic<uint64_t> divisor{1};
+    auto walk = [&](unsigned lane) {
+        RhoCancelFlag cancel{&found};
+        for (uint64_t c = first_constant + lane; c < n; c += threads) {
+            uint64_t result = pollardRhoBrent(n, c, cancel);
+            if (result == 1) return;  // cancelled
+            if (result != n) {
+                bool expected = false;
+                if (found.compare_exchange_strong(expected, true)) {
+                    divisor.store(result, std::memory_order_relaxed);
+                }
+                return;
+            }
+        }
+    };
+    std::unique_ptr<std::thread[]> helpers(
+        new (std::nothrow) std::thread[threads - 1]);
+#if IMATHLIB_STATS
+    std::unique_ptr<Stats[]> helper_stats(
+        new (std::nothrow) Stats[threads - 1]{});
+    if (!helper_stats) helpers.reset();
+#endif
+    if (!helpers) {
+        // Out of memory, a single walk on the calling thread goes on
+        RhoNoLimit no_limit{};
+        return rhoDivisor(n, polynomial_constant, no_limit);
+    }
+    auto helper = [&](unsigned lane) {
+        walk(lane);
+#if IMATHLIB_STATS
+        helper_stats[lane - 1] = threadStats();
+#endif
+    };
+    unsigned started = 1;
+#if IMATHLIB_HAS_EXCEPTIONS
+    try {
+#endif
+        for (; started < threads; ++started) {
+            helpers[started - 1] = std::thread(helper, started);
+        }
+#if IMATHLIB_HAS_EXCEPTIONS
+    } catch (const std::system_error&) {
+        // Out of threads, the calling thread walks the rest of the lanes
+    }
+#endif
+    walk(0);
+    for (unsigned lane = started; lane < threads; ++lane) {
+        walk(lane);
+    }
+    for (unsigned lane = 1; lane < started; ++lane) {
+        helpers[lane - 1].join();
+#if IMATHLIB_STATS
+        statsAdd(helper_stats[lane - 1]);
+#endif
+    }
+    polynomial_constant += threads;
+    return divisor.load(std::memory_order_relaxed);
+}
+#endif
+
+/**
+ * isPrime, timed as the primality stage of factorize with IMATHLIB_STATS.
+ * */
+template <typename T>
+constexpr bool isPrimeTimed(T n) noexcept {
+    IMATHLIB_STATS_TIMER(start);
+    bool prime = isPrime(n);
+    IMATHLIB_STATS_ELAPSED(start, primality_ns);
+    return prime;
+}
+
+/**
+ * Binary extended GCD (Kaliski's almost inverse), only for an odd modulo.
+ * Returns 0 if n is not invertible.
+ *
+ * Keeps both u and v odd, and n * s = v * 2^k, n * r = -u * 2^k (mod mod)
+ * with u * s + v * r = mod, so that r, s never exceed mod.
+ * Every subtraction makes one of u, v even, its trailing zeroes are removed
+ * with a single shift, and the other coefficient is multiplied by 2^ctz
+ * instead of halving this one ctz times.
+ * At the end u = v = gcd, s + r = mod, and s * 2^-k is the inverse.
+ * */
+template <typename T>
+IMATHLIB_CONSTEXPR_INTR T modInverseBinary(T n, T mod) noexcept {
+    IMATHLIB_ASSERT(mod & 1);
+    T v = n % mod;
+    if (v == 0) return 0;
+    T u = mod;
+    T r = 0;
+    T s = 1;
+    int k = detail::ctz(v);
+    v >>= k;
+    // Pairs (u, r) and (v, s) are swapped to keep v larger,
+    // which flips the signs in the invariant above.
+    bool negated = false;
+
+    while (u != v) {
+        bool swap = u > v;
+        detail::simpleSwapIf(u, v, swap);
+        detail::simpleSwapIf(r, s, swap);
+        negated ^= swap;
+        v -= u;
+        s += r;
+        int tz = detail::ctz(v);
+        v >>= tz;
+        r <<= tz;
+        k += tz;
+    }
+    if (u != 1) return 0;
+
+    return divPow2Mod(negated ? r : s, k, mod, inverseModPow2(mod));
+}
+
+/**
+ * Calculates x^e, or returns UINT64_MAX if the result doesn't fit in 64 bits.
+ * */
+constexpr uint64_t powSaturated(uint64_t x, uint32_t e) noexcept {
+    uint64_t result = 1;
+    for (uint32_t i = 0; i < e; ++i) {
+        if (x != 0 && result > UINT64_MAX / x) return UINT64_MAX;
+        result *= x;
+    }
+    return result;
+}
+
+/**
+ * 10^i for all i, that fit in 64 bits.
+ * */
+constexpr uint64_t kPowersOf10[20] {
+    1ull,
+    10ull,
+    100ull,
+    1000ull,
+    10000ull,
+    100000ull,
+    1000000ull,
+    10000000ull,
+    100000000ull,
+    1000000000ull,
+    10000000000ull,
+    100000000000ull,
+    1000000000000ull,
+    10000000000000ull,
+    100000000000000ull,
+    1000000000000000ull,
+    10000000000000000ull,
+    100000000000000000ull,
+    1000000000000000000ull,
+    10000000000000000000ull
+};
+
+/**
+ * Integer k-th root using Newton's method, floor(n ^ (1/k)).
+ * Starts from a power of 2 not smaller than the root, based on the bit length
+ * of n, and then the iteration decreases monotonically to the exact result.
+ * Constexpr friendly, but it performs a few 64-bit divisions.
+ * */
+IMATHLIB_CONSTEXPR_INTR uint64_t irootNewton(uint64_t n, uint32_t k) noexcept {
+    IMATHLIB_ASSUME(k >= 2);
+    if (n < 2) return n;
+    int bits = 64 - detail::clz(n);
+    if (static_cast<uint32_t>(bits) <= k) return 1;
+    uint64_t x = uint64_t{1} << ((static_cast<uint32_t>(bits) + k - 1) / k);
+    while (true) {
+        // n / x^(k-1) is 0 when x^(k-1) overflows, as expected
+        uint64_t y = ((k - 1) * x + n / powSaturated(x, k - 1)) / k;
+        if (y >= x) return x;
+        x = y;
+    }
+}
+
+IMATHLIB_CONSTEXPR_INTR uint64_t isqrtNewton(uint64_t n) noexcept {
+    if (n < 2) return n;
+    int bits = 64 - detail::clz(n);
+    uint64_t x = uint64_t{1} << ((bits + 1) / 2);
+    while (true) {
+        uint64_t y = (x + n / x) / 2;
+        if (y >= x) return x;
+        x = y;
+    }
+}
+
+/**
+ * Integer square root from floating point square root.
+ * Conversion of n to double may round it, so the result is corrected
+ * by at most 1 to be exact for all 64-bit numbers.
+ * */
+inline uint64_t isqrtFloat(uint64_t n) noexcept {
+    uint64_t root = static_cast<uint64_t>(std::sqrt(static_cast<double>(n)));
+    root = detail::min(root, uint64_t{UINT32_MAX});
+    if (root * root > n) {
+        --root;
+    } else if (root < UINT32_MAX && (root + 1) * (root + 1) <= n) {
+        ++root;
+    }
+    return root;
+}
+
+/**
+ * Integer cube root from floating point cube root,
+ * corrected to be exact for all 64-bit numbers.
+ * */
+inline uint64_t icbrtFloat(uint64_t n) noexcept {
+    constexpr uint64_t kMaxRoot = 2642245;  // floor(cbrt(2^64 - 1))
+    uint64_t root = static_cast<uint64_t>(std::cbrt(static_cast<double>(n)));
+    root = detail::min(root, kMaxRoot);
+    if (root * root * root > n) {
+        --root;
+    } else if (root < kMaxRoot && (root + 1) * (root + 1) * (root + 1) <= n) {
+        ++root;
+    }
+    return root;
+}
+
+/**
+ * Floating point k-th root rounded to the nearest integer.
+ * It isn't always floor(n ^ (1/k)), but it is exact for perfect powers,
+ * as rounding errors are far below 1/2.
+ * */
+inline uint64_t irootNearestFloat(uint64_t n, uint32_t k) noexcept {
+    return static_cast<uint64_t>(
+        std::pow(static_cast<double>(n), 1.0 / k) + 0.5);
+}
+
+/**
+ * Bit mask with bit (r mod 64) lit, for every quadratic residue r modulo mod.
+ * */
+constexpr uint64_t squareResiduesMask(uint32_t mod) noexcept {
+    uint64_t mask = 0;
+    for (uint64_t i = 0; i < mod; ++i) {
+        mask |= uint64_t{1} << (i * i % mod % 64);
+    }
+    return mask;
+}
+
+constexpr uint64_t kSquaresMod64 = squareResiduesMask(64);
+constexpr uint64_t kSquaresMod63 = squareResiduesMask(63);
+// 64 ≡ -1 is a square modulo 65, so it can share the bit with 0
+constexpr uint64_t kSquaresMod65 = squareResiduesMask(65);
+constexpr uint64_t kSquaresMod11 = squareResiduesMask(11);
+constexpr uint64_t kSquaresMod31 = squareResiduesMask(31);
+
+/**
+ * Quadratic residue filters modulo 63, 65, 11 and 31.
+ * Returns false if n is certainly not a perfect square.
+ * Together with the modulo 64 test they reject over 99.5% of non-squares.
+ * */
+constexpr bool isSquareModSmallOdd(uint64_t n) noexcept {
+    // 1396395 = 63 * 65 * 11 * 31, compiled to a multiplication
+    uint32_t r = static_cast<uint32_t>(n % 1396395);
+    return ((kSquaresMod63 >> (r % 63)) &
+            (kSquaresMod65 >> (r % 65 % 64)) &
+            (kSquaresMod11 >> (r % 11)) &
+            (kSquaresMod31 >> (r % 31)) & 1) != 0;
+}
+
+/**
+ * Bit mask with bit r lit, for every k-th power residue r modulo mod <= 64.
+ * */
+constexpr uint64_t powerResiduesMask(uint32_t k, uint32_t mod) noexcept {
+    uint64_t mask = 0;
+    for (uint64_t i = 0; i < mod; ++i) {
+        uint64_t power = 1;
+        for (uint32_t j = 0; j < k; ++j) {
+            power = power * i % mod;
+        }
+        mask |= uint64_t{1} << power;
+    }
+    return mask;
+}
+
+// For a prime k, modulo a prime q = 1 (mod k) there are only
+// (q - 1) / k + 1 k-th power residues, so each such q rejects most numbers
+constexpr uint64_t kCubesMod7 = powerResiduesMask(3, 7);
+constexpr uint64_t kCubesMod13 = powerResiduesMask(3, 13);
+constexpr uint64_t kCubesMod19 = powerResiduesMask(3, 19);
+constexpr uint64_t kFifthPowersMod11 = powerResiduesMask(5, 11);
+constexpr uint64_t kFifthPowersMod31 = powerResiduesMask(5, 31);
+constexpr uint64_t kFifthPowersMod41 = powerResiduesMask(5, 41);
+constexpr uint64_t kSeventhPowersMod29 = powerResiduesMask(7, 29);
+constexpr uint64_t kSeventhPowersMod43 = powerResiduesMask(7, 43);
+constexpr uint64_t kEleventhPowersMod23 = powerResiduesMask(11, 23);
+constexpr uint64_t kThirteenthPowersMod53 = powerResiduesMask(13, 53);
+
+/**
+ * Returns false if n is certainly not a k-th power, for a prime k.
+ * Only k <= 13 are filtered, larger powers need moduli above 64.
+ * */
+constexpr bool isPowerResidue(uint64_t n, uint32_t k) noexcept {
+    if (k == 2) {
+        return isSquareModSmallOdd(n);
+    }
+    if (k == 3) {
+        return ((kCubesMod7 >> (n % 7)) & (kCubesMod13 >> (n % 13)) &
+                (kCubesMod19 >> (n % 19)) & 1) != 0;
+    }
+    if (k == 5) {
+        return ((kFifthPowersMod11 >> (n % 11)) &
+                (kFifthPowersMod31 >> (n % 31)) &
+                (kFifthPowersMod41 >> (n % 41)) & 1) != 0;
+    }
+    if (k == 7) {
+        return ((kSeventhPowersMod29 >> (n % 29)) &
+                (kSeventhPowersMod43 >> (n % 43)) & 1) != 0;
+    }
+    if (k == 11) {
+        return ((kEleventhPowersMod23 >> (n % 23)) & 1) != 0;
+    }
+    if (k == 13) {
+        return ((kThirteenthPowersMod53 >> (n % 53)) & 1) != 0;
+    }
+    return true;
+}
+
+#if IMATHLIB_AVX2_KERNELS
+/**
+ * r % mod for 4 remainders r < 4101 at once, with q = (r * magic) >> 20
+ * used instead of division. Magic values are ceil(2^20 / mod).
+ * */
+IMATHLIB_TARGET_AVX2
+inline __m256i remainderSmallAvx2(__m256i r, uint32_t mod, uint32_t magic) {
+    __m256i q = _mm256_mul_epu32(r, _mm256_set1_epi64x(magic));
+    q = _mm256_srli_epi64(q, 20);
+    return _mm256_sub_epi64(r, _mm256_mul_epu32(q, _mm256_set1_epi64x(mod)));
+}
+
+IMATHLIB_TARGET_AVX2
+inline __m256i testBitsAvx2(uint64_t mask, __m256i bits) {
+    return _mm256_srlv_epi64(
+        _mm256_set1_epi64x(static_cast<long long>(mask)), bits);
+}
+
+/**
+ * AVX2 version of modulo 64 and isSquareModSmallOdd filters
+ * for 4 numbers at once. Returns the 4-bit mask of the numbers
+ * that passed all the filters.
+ *
+ * There is no 64-bit high multiplication in AVX2, but 4095 = 63 * 65
+ * and 1023 = 3 * 11 * 31, so the remainders are found by summing
+ * 12-bit and 10-bit digits of n, and then reduced with 32-bit multiplications.
+ * */
+IMATHLIB_TARGET_AVX2
+inline int isSquareResidueAvx2(__m256i n) {
+    const __m256i mask10 = _mm256_set1_epi64x(0x3FF);
+    const __m256i mask12 = _mm256_set1_epi64x(0xFFF);
+    __m256i s12 = _mm256_and_si256(n, mask12);
+    s12 = _mm256_add_epi64(
+        s12, _mm256_and_si256(_mm256_srli_epi64(n, 12), mask12));
+    s12 = _mm256_add_epi64(
+        s12, _mm256_and_si256(_mm256_srli_epi64(n, 24), mask12));
+    s12 = _mm256_add_epi64(
+        s12, _mm256_and_si256(_mm256_srli_epi64(n, 36), mask12));
+    s12 = _mm256_add_epi64(
+        s12, _mm256_and_si256(_mm256_srli_epi64(n, 48), mask12));
+    s12 = _mm256_add_epi64(s12, _mm256_srli_epi64(n, 60));
+    __m256i r4095 = _mm256_add_epi64(_mm256_and_si256(s12, mask12),
+                                     _mm256_srli_epi64(s12, 12));
+    __m256i s10 = _mm256_and_si256(n, mask10);
+    s10 = _mm256_add_epi64(
+        s10, _mm256_and_si256(_mm256_srli_epi64(n, 10), mask10));
+    s10 = _mm256_add_epi64(
+        s10, _mm256_and_si256(_mm256_srli_epi64(n, 20), mask10));
+    s10 = _mm256_add_epi64(
+        s10, _mm256_and_si256(_mm256_srli_epi64(n, 30), mask10));
+    s10 = _mm256_add_epi64(
+        s10, _mm256_and_si256(_mm256_srli_epi64(n, 40), mask10));
+    s10 = _mm256_add_epi64(
+        s10, _mm256_and_si256(_mm256_srli_epi64(n, 50), mask10));
+    s10 = _mm256_add_epi64(s10, _mm256_srli_epi64(n, 60));
+    __m256i r1023 = _mm256_add_epi64(_mm256_and_si256(s10, mask10),
+                                     _mm256_srli_epi64(s10, 10));
+
+    __m256i r64 = _mm256_and_si256(n, _mm256_set1_epi64x(63));
+    __m256i r63 = remainderSmallAvx2(r4095, 63, 16645);
+    __m256i r65 = remainderSmallAvx2(r4095, 65, 16132);
+    r65 = _mm256_and_si256(r65, _mm256_set1_epi64x(63));
+    __m256i r11 = remainderSmallAvx2(r1023, 11, 95326);
+    __m256i r31 = remainderSmallAvx2(r1023, 31, 33826);
+
+    __m256i result = testBitsAvx2(kSquaresMod64, r64);
+    result = _mm256_and_si256(result, testBitsAvx2(kSquaresMod63, r63));
+    result = _mm256_and_si256(result, testBitsAvx2(kSquaresMod65, r65));
+    result = _mm256_and_si256(result, testBitsAvx2(kSquaresMod11, r11));
+    result = _mm256_and_si256(result, testBitsAvx2(kSquaresMod31, r31));
+    // move the lowest bit to the sign bit, to extract it with movemask
+    result = _mm256_slli_epi64(result, 63);
+    return _mm256_movemask_pd(_mm256_castsi256_pd(result));
+}
+
+/**
+ * results[i] = whether numbers[i] passed the residue filters, 4 at once.
+ * Returns how many of them were done.
+ * */
+IMATHLIB_TARGET_AVX2
+inline size_t isSquareResidueAvx2(const uint64_t* numbers, size_t count,
+                                  bool* results) noexcept {
+    size_t vectorized = count / 4 * 4;
+    for (size_t i = 0; i < vectorized; i += 4) {
+        __m256i n = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(numbers + i));
+        int passed = isSquareResidueAvx2(n);
+        results[i + 0] = (passed >> 0) & 1;
+        results[i + 1] = (passed >> 1) & 1;
+        results[i + 2] = (passed >> 2) & 1;
+        results[i + 3] = (passed >> 3) & 1;
+    }
+    return vectorized;
+}
+
+/**
+ * Montgomery multiplication of 8 32-bit numbers by the same w, mod < 2^31.
+ * _mm256_mul_epu32 multiplies only even 32-bit lanes, so odd lanes are
+ * shifted down, and high halves of both products are merged back.
+ * */
+IMATHLIB_TARGET_AVX2
+inline __m256i montgomeryMulAvx2(__m256i a, __m256i w, __m256i mod,
+                                 __m256i mod_inverse) {
+    __m256i x_even = _mm256_mul_epu32(a, w);
+    __m256i x_odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), w);
+    __m256i t_even = _mm256_mul_epu32(x_even, mod_inverse);
+    __m256i t_odd = _mm256_mul_epu32(x_odd, mod_inverse);
+    __m256i tm_even = _mm256_mul_epu32(t_even, mod);
+    __m256i tm_odd = _mm256_mul_epu32(t_odd, mod);
+    // high 32 bits of even products to even lanes, odd stay in place
+    __m256i x_hi = _mm256_blend_epi32(_mm256_srli_epi64(x_even, 32),
+                                      x_odd, 0b10101010);
+    __m256i tm_hi = _mm256_blend_epi32(_mm256_srli_epi64(tm_even, 32),
+                                       tm_odd, 0b10101010);
+    // x_hi - tm_hi is in (-mod, mod), min picks the one in [0, mod)
+    __m256i diff = _mm256_sub_epi32(x_hi, tm_hi);
+    return _mm256_min_epu32(diff, _mm256_add_epi32(diff, mod));
+}
+
+/**
+ * (a + b) mod mod and (a - b) mod mod, for a, b < mod < 2^31.
+ * */
+IMATHLIB_TARGET_AVX2
+inline __m256i addModAvx2(__m256i a, __m256i b, __m256i mod) {
+    __m256i sum = _mm256_add_epi32(a, b);
+    return _mm256_min_epu32(sum, _mm256_sub_epi32(sum, mod));
+}
+
+IMATHLIB_TARGET_AVX2
+inline __m256i subModAvx2(__m256i a, __m256i b, __m256i mod) {
+    __m256i diff = _mm256_sub_epi32(a, b);
+    return _mm256_min_epu32(diff, _mm256_add_epi32(diff, mod));
+}
+
+/**
+ * Radix-4 NTT butterflies of Ntt<uint32_t> for x[0..4 * quarter),
+ * 8 at once, see Ntt::forwardRadix4 and Ntt::inverseRadix4.
+ * Returns how many of them were done, the rest is left to scalar code.
+ * */
+IMATHLIB_TARGET_AVX2
+inline size_t forwardRadix4Avx2(uint32_t* x, size_t quarter, uint32_t w1,
+                                uint32_t w2, uint32_t w3, uint32_t mod,
+                                uint32_t mod_inverse) noexcept {
+    const __m256i vw1 = _mm256_set1_epi32(static_cast<int>(w1));
+    const __m256i vw2 = _mm256_set1_epi32(static_cast<int>(w2));
+    const __m256i vw3 = _mm256_set1_epi32(static_cast<int>(w3));
+    const __m256i vmod = _mm256_set1_epi32(static_cast<int>(mod));
+    const __m256i vinv = _mm256_set1_epi32(static_cast<int>(mod_inverse));
+    auto* p0 = reinterpret_cast<__m256i*>(x);
+    auto* p1 = reinterpret_cast<__m256i*>(x + quarter);
+    auto* p2 = reinterpret_cast<__m256i*>(x + 2 * quarter);
+    auto* p3 = reinterpret_cast<__m256i*>(x + 3 * quarter);
+    size_t vectorized = quarter / 8 * 8;
+    for (size_t i = 0; i < vectorized / 8; ++i) {
+        __m256i a0 = _mm256_loadu_si256(p0 + i);
+        __m256i a1 = _mm256_loadu_si256(p1 + i);
+        __m256i a2 = montgomeryMulAvx2(_mm256_loadu_si256(p2 + i), vw1,
+                                       vmod, vinv);
+        __m256i a3 = montgomeryMulAvx2(_mm256_loadu_si256(p3 + i), vw1,
+                                       vmod, vinv);
+        __m256i b0 = addModAvx2(a0, a2, vmod);
+        __m256i b2 = subModAvx2(a0, a2, vmod);
+        __m256i b1 = montgomeryMulAvx2(addModAvx2(a1, a3, vmod), vw2,
+                                       vmod, vinv);
+        __m256i b3 = montgomeryMulAvx2(subModAvx2(a1, a3, vmod), vw3,
+                                       vmod, vinv);
+        _mm256_storeu_si256(p0 + i, addModAvx2(b0, b1, vmod));
+        _mm256_storeu_si256(p1 + i, subModAvx2(b0, b1, vmod));
+        _mm256_storeu_si256(p2 + i, addModAvx2(b2, b3, vmod));
+        _mm256_storeu_si256(p3 + i, subModAvx2(b2, b3, vmod));
+    }
+    return vectorized;
+}
+
+IMATHLIB_TARGET_AVX2
+inline size_t inverseRadix4Avx2(uint32_t* x, size_t quarter, uint32_t w1,
+                                uint32_t w2, uint32_t w3, uint32_t mod,
+                                uint32_t mod_inverse) noexcept {
+    const __m256i vw1 = _mm256_set1_epi32(static_cast<int>(w1));
+    const __m256i vw2 = _mm256_set1_epi32(static_cast<int>(w2));
+    const __m256i vw3 = _mm256_set1_epi32(static_cast<int>(w3));
+    const __m256i vmod = _mm256_set1_epi32(static_cast<int>(mod));
+    const __m256i vinv = _mm256_set1_epi32(static_cast<int>(mod_inverse));
+    auto* p0 = reinterpret_cast<__m256i*>(x);
+    auto* p1 = reinterpret_cast<__m256i*>(x + quarter);
+    auto* p2 = reinterpret_cast<__m256i*>(x + 2 * quarter);
+    auto* p3 = reinterpret_cast<__m256i*>(x + 3 * quarter);
+    size_t vectorized = quarter / 8 * 8;
+    for (size_t i = 0; i < vectorized / 8; ++i) {
+        __m256i a0 = _mm256_loadu_si256(p0 + i);
+        __m256i a1 = _mm256_loadu_si256(p1 + i);
+        __m256i a2 = _mm256_loadu_si256(p2 + i);
+        __m256i a3 = _mm256_loadu_si256(p3 + i);
+        __m256i b0 = addModAvx2(a0, a1, vmod);
+        __m256i b1 = montgomeryMulAvx2(subModAvx2(a0, a1, vmod), vw2,
+                                       vmod, vinv);
+        __m256i b2 = addModAvx2(a2, a3, vmod);
+        __m256i b3 = montgomeryMulAvx2(subModAvx2(a2, a3, vmod), vw3,
+                                       vmod, vinv);
+        _mm256_storeu_si256(p0 + i, addModAvx2(b0, b2, vmod));
+        _mm256_storeu_si256(p1 + i, addModAvx2(b1, b3, vmod));
+        _mm256_storeu_si256(p2 + i, montgomeryMulAvx2(
+            subModAvx2(b0, b2, vmod), vw1, vmod, vinv));
+        _mm256_storeu_si256(p3 + i, montgomeryMulAvx2(
+            subModAvx2(b1, b3, vmod), vw1, vmod, vinv));
+    }
+    return vectorized;
+}
+
+// 64-bit lanes have no 64x64 bit multiplication in AVX2
+inline size_t forwardRadix4Avx2(uint64_t*, size_t, uint64_t, uint64_t,
+                                uint64_t, uint64_t, uint64_t) noexcept {
+    return 0;
+}
+
+inline size_t inverseRadix4Avx2(uint64_t*, size_t, uint64_t, uint64_t,
+                                uint64_t, uint64_t, uint64_t) noexcept {
+    return 0;
+}
+#endif  // IMATHLIB_AVX2_KERNELS
+
+/**
+ * floor(log2(n) * 2^16) for n > 0, give or take a few units
+ * in the last place. Fractional bits come from squaring the mantissa.
+ * */
+constexpr uint64_t log2Fixed16(uint64_t n) noexcept {
+    int exponent = 63 - clzFallback(n);
+    // [1, 2) with 31 fractional bits, so that squares fit in 64 bits
+    uint64_t mantissa = exponent >= 31 ? n >> (exponent - 31)
+                                       : n << (31 - exponent);
+    uint64_t result = static_cast<uint64_t>(exponent) << 16;
+    for (int bit = 15; bit >= 0; --bit) {
+        mantissa = (mantissa * mantissa) >> 31;
+        if (mantissa >= (uint64_t{1} << 32)) {
+            mantissa >>= 1;
+            result |= uint64_t{1} << bit;
+        }
+    }
+    return result;
+}
+
+/**
+ * Upper bound of the n-th prime, counting 2 as the first one.
+ * Rosser and Schoenfeld: p_n < n * (ln n + ln ln n) for n >= 6.
+ * */
+constexpr uint64_t nthPrimeUpperBound(uint64_t n) noexcept {
+    if (n < 6) return 11;
+    // ln 2 * 2^16, rounded up
+    const uint64_t ln2 = 45427;
+    // Logarithms * 2^16, rounded up generously
+    uint64_t ln_n = ((log2Fixed16(n) + 4) * ln2 >> 16) + 1;
+    uint64_t ln_ln_n = ((log2Fixed16(ln_n) + 4) * ln2 >> 16) + 1 - 16 * ln2;
+    return (n * (ln_n + ln_ln_n) >> 16) + 1;
+}
+
+// Residues coprime to 30. A byte of the wheel sieve covers 30 numbers,
+// a bit for each of them
+constexpr uint8_t kWheel30Residues[8] = {1, 7, 11, 13, 17, 19, 23, 29};
+constexpr uint8_t kWheel30Gaps[8] = {6, 4, 2, 4, 2, 4, 6, 2};
+// Index of the smallest residue >= r, the bit of r if it is a residue
+constexpr uint8_t kWheel30Next[30] = {
+    0, 0, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 4,
+    4, 4, 4, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7, 7, 7};
+
+/**
+ * Marks multiples p * k >= start, with k coprime to 30, in a wheel
+ * sieve segment of [low, high), with low divisible by 30.
+ * Other multiples of p are not in the wheel at all.
+ *
+ * Bits and byte distances of consecutive multiples repeat every 8 of
+ * them, as p * (k + 30) = p * k + 30 * p, so they are computed once.
+ * */
+constexpr void crossOffWheel30(uint8_t* segment, uint64_t low, uint64_t high,
+                               uint64_t p, uint64_t start) noexcept {
+    uint64_t k = (start + p - 1) / p;
+    size_t idx = kWheel30Next[k % 30];
+    k += kWheel30Residues[idx] - k % 30;
+    if (p * k >= high) return;
+
+    uint64_t byte = (p * k - low) / 30;
+    uint64_t end = (high - low) / 30;
+    uint8_t bits[8]{};
+    uint64_t byte_steps[8]{};
+    for (size_t j = 0; j < 8; ++j) {
+        uint64_t m = p * k;
+        k += kWheel30Gaps[(idx + j) & 7];
+        bits[j] = static_cast<uint8_t>(1u << kWheel30Next[m % 30]);
+        byte_steps[j] = (p * k) / 30 - m / 30;
+    }
+    for (size_t j = 0; byte < end; j = (j + 1) & 7) {
+        segment[byte] |= bits[j];
+        byte += byte_steps[j];
+    }
+}
+
+} // namespace detail
+
+template <size_t SIZE, typename T>
+class PrimeArray {
+public:
+    static_assert(std::is_integral<T>::value, "PrimeArray must contain integers");
+    static_assert(SIZE > 0, "Empty PrimeArray is not allowed");
+
+    /**
+     * Segmented sieve on a 2-3-5 wheel, a bit for each number coprime
+     * to 30. Segments are no larger than needed for the first SIZE primes,
+     * as bounded by detail::nthPrimeUpperBound.
+     * */
+    constexpr
+    PrimeArray() noexcept : array{} {
+        constexpr const size_t segment_size = getSegmentSize();
+        const uint8_t wheel_primes[3] = {2, 3, 5};
+        size_t filled = 0;
+        for (; filled < SIZE && filled < 3; ++filled) {
+            array[filled] = static_cast<T>(wheel_primes[filled]);
+        }
+        for (uint64_t low = 0; filled < SIZE; low += 30 * segment_size) {
+            uint8_t segment[segment_size]{};  // bits of composites
+            uint64_t high = low + 30 * segment_size;
+            for (size_t i = 3; i < filled; ++i) {
+                uint64_t p = static_cast<uint64_t>(array[i]);
+                if (p * p >= high) break;
+                detail::crossOffWheel30(segment, low, high, p,
+                                        detail::max(p * p, low));
+            }
+            for (size_t byte = 0; byte < segment_size; ++byte) {
+                for (size_t bit = 0; bit < 8; ++bit) {
+                    if ((segment[byte] >> bit) & 1) continue;
+                    uint64_t n = low + 30 * byte +
+                                 detail::kWheel30Residues[bit];
+                    if (n == 1) continue;
+                    array[filled++] = static_cast<T>(n);
+                    if (filled == SIZE) return;
+                    if (n * n < high) {
+                        detail::crossOffWheel30(segment, low, high, n, n * n);
+                    }
+                }
+            }
+        }
+    }
+
+    constexpr size_t size() const noexcept {
+        return SIZE;
+    }
+    constexpr const T* begin() const noexcept {
+        return array;
+    }
+    constexpr const T* end() const noexcept {
+        return array + SIZE;
+    }
+    constexpr const T& operator[](size_t idx) const {
+        return array[idx];
+    }
+    constexpr const T& back() const {
+        return array[SIZE - 1];
+    }
+
+private:
+    T array[SIZE];
+    constexpr static size_t getSegmentSize() noexcept {
+        return static_cast<size_t>(detail::min(
+            uint64_t{1024}, detail::nthPrimeUpperBound(SIZE) / 30 + 1));
+    }
+};
+
+constexpr PrimeArray<64, uint16_t> kSmallPrimes;
+
+IMATHLIB_CONSTEXPR_INTR bool isPrime(uint32_t n) noexcept {
+    IMATHLIB_STATS_ADD(isprime_calls, 1);
+    if (n == 2 || n == 3 || n == 5 || n == 7) return true;
+    if (n % 2 == 0 || n % 3 == 0 || n % 5 == 0 || n % 7 == 0) return false;
+    if (n < 121) return (n > 1);
+    uint64_t h = n;  // important - 64 bits
+    h = ((h >> 16) ^ h) * 0x979bc64f;
+    h = ((h >> 16) ^ h) * 0x979bc64f;
+    h = ((h >> 16) ^ h) & 255;
+    return detail::isSPRP(n, detail::bases_prime_test_u32[h]);
+}
+
+IMATHLIB_CONSTEXPR_X64 bool isPrime(uint64_t n) noexcept {
+    if (n < (1ull << 32)) return isPrime(static_cast<uint32_t>(n));
+    IMATHLIB_STATS_ADD(isprime_calls, 1);
+    if (n % 2 == 0 || n % 3 == 0 || n % 5 == 0 || n % 7 == 0) return false;
+
+    if (!detail::isSPRP(n, 2)) return false;
+
+    // Steve Worley, 2013
+    // Most composites fail base 2 above, and for the rest of the numbers
+    // the remaining bases are tested at once
+    if (n < 109134866497) {
+        const uint64_t bases[] = {1005905886, 1340600841};
+        return detail::isSPRP(n, bases, 2);
+    }
+
+    if (n < 55245642489451) {
+        const uint64_t bases[] = {141889084524735, 1199124725622454117,
+                                  11096072698276303650u};
+        return detail::isSPRP(n, bases, 3);
+    }
+
+    uint64_t h = n;
+    h = ((h >> 32) ^ h) * 0x123456789abce1b;
+    h = ((h >> 32) ^ h) * 0x123456789abce1b;
+    h = ((h >> 32) ^ h) & 127;
+
+    uint32_t bs = detail::bases_prime_test_u64[h];
+    // see comments above detail::bases_prime_test_u64 for details
+    auto b1 = 15u;
+    auto b2 = (bs >> 22) & 0x3FF;
+    auto b3 = (bs >> 11) & 0x7FF;
+    auto b4 = (bs >> 0) & 0x7FF;
+    const uint64_t bases[] = {b1, b2, b3, b4};
+    return detail::isSPRP(n, bases, 4);
+}
+
+IMATHLIB_CONSTEXPR_INTR uint32_t nextPrimeAfter(uint32_t n) {
+    IMATHLIB_ASSERT(n < 4294967291u);
+    if (n < 2) return 2;
+    for (n = n + 1 + (n & 1); !isPrime(n); n += 2);
+    return n;
+}
+IMATHLIB_CONSTEXPR_X64 uint64_t nextPrimeAfter(uint64_t n) {
+    IMATHLIB_ASSERT(n < 18446744073709551557ull);
+    if (n < 4294967291u) {  // biggest 32-bit prime
+        return nextPrimeAfter(static_cast<uint32_t>(n));
+    }
+    for (n = n + 1 + (n & 1); !isPrime(n); n += 2);
+    return n;
+}
+
+/**
+ * n = root^exponent with the largest possible exponent.
+ * Exponent is 1 if n is not a perfect power, 0 and 1 are not either.
+ * Converts to true for perfect powers.
+ * */
+struct PerfectPowerU32 {
+    uint32_t root;
+    uint32_t exponent;
+
+    constexpr explicit operator bool() const noexcept {
+        return exponent > 1;
+    }
+};
+
+struct PerfectPowerU64 {
+    uint64_t root;
+    uint32_t exponent;
+
+    constexpr explicit operator bool() const noexcept {
+        return exponent > 1;
+    }
+};
+
+struct FactorU32 {
+    uint32_t prime;
+    uint32_t power;
+};
+
+/**
+ * Stores results of a 32-bit number factorization.
+ * Results are in a form of pairs {prime, power}. Primes are in ascending order.
+ * Multiplication of all pairs [i].prime ** [i].power will give the original
+ * factored number.
+ * */
+class FactorizationResultU32 {
+public:
+    constexpr size_t size() const noexcept {
+        return size_;
+    }
+    constexpr const FactorU32* begin() const noexcept {
+        return factors_;
+    }
+    constexpr const FactorU32* end() const noexcept {
+        return factors_ + size_;
+    }
+    constexpr const FactorU32& operator[](size_t idx) const {
+        return factors_[idx];
+    }
+    constexpr const FactorU32& back() const {
+        return factors_[size_ - 1];
+    }
+
+private:
+    /**
+     * Used to add prime factors found in incresing order using trialdivision
+     * */
+    constexpr void addFactor(FactorU32 f) {
+        factors_[size_++] = f;
+    }
+
+    /**
+     * Used to add prime factors found in not specified order.
+     * Performs a linear search to find if the prime factor already occured.
+     * Then either adds power to the existing factor, or performs insertion.
+     * */
+    constexpr void addUnorderedFactor(FactorU32 f) {
+        size_t i = 0;
+        for (; i < size_ && factors_[i].prime < f.prime; ++i);
+        if (factors_[i].prime == f.prime) {
+            factors_[i].power += f.power;
+            return;
+        }
+        // if not found, perform an insertion
+        FactorU32 swapper = f;
+        for (; i < size_; ++i) {
+            detail::simpleSwap(swapper, factors_[i]);
+        }
+        factors_[size_++] = swapper;
+    }
+
+    FactorU32 factors_[10]{};
+    size_t size_{};
+    friend IMATHLIB_CONSTEXPR_INTR
+    FactorizationResultU32 factorize(uint32_t n) noexcept;
+    template <size_t N>
+    friend class FactorTable;
+};
+
+struct FactorU64 {
+    uint64_t prime;
+    uint64_t power;
+};
+
+/**
+ * Stores results of a 64-bit number factorization.
+ * Results are in a form of pairs {prime, power}. Primes are in ascending order.
+ * Multiplication of all pairs [i].prime ** [i].power will give the original
+ * factored number.
+ * */
+class FactorizationResultU64 {
+public:
+    constexpr size_t size() const noexcept {
+        return size_;
+    }
+    constexpr const FactorU64* begin() const noexcept {
+        return factors_;
+    }
+    constexpr const FactorU64* end() const noexcept {
+        return factors_ + size_;
+    }
+    constexpr const FactorU64& operator[](size_t idx) const {
+        return factors_[idx];
+    }
+    constexpr const FactorU64& back() const {
+        return factors_[size_ - 1];
+    }
+
+private:
+    /**
+     * Used to add prime factors found in incresing order using trialdivision
+     * */
+    constexpr void addFactor(FactorU64 f) {
+        factors_[size_++] = f;
+    }
+
+    /**
+     * Used to add prime factors found in not specified order.
+     * Performs a linear search to find if the prime factor already occured.
+     * Then either adds power to the existing factor, or performs insertion.
+     * */
+    constexpr void addUnorderedFactor(FactorU64 f) {
+        size_t i = 0;
+        for (; i < size_ && factors_[i].prime < f.prime; ++i);
+        if (factors_[i].prime == f.prime) {
+            factors_[i].power += f.power;
+            return;
+        }
+        // if not found, perform an insertion
+        FactorU64 swapper = f;
+        for (; i < size_; ++i) {
+            detail::simpleSwap(swapper, factors_[i]);
+        }
+        factors_[size_++] = swapper;
+    }
+
+    FactorU64 factors_[16]{};
+    size_t size_{};
+    friend class PartialFactorizationU64;
+    friend class FactorizationCache;
+};
+
+IMATHLIB_CONSTEXPR_INTR FactorizationResultU32 factorize(uint32_t n) noexcept {
+    IMATHLIB_STATS_ADD(factorize_calls, 1);
+    FactorizationResultU32 result{};
+    if (n <= 1) return result;
+
+    if (n % 2 == 0) {
+        int trailing_zeroes = detail::ctz(n);
+        n >>= trailing_zeroes;
+        result.addFactor({2, static_cast<uint32_t>(trailing_zeroes)});
+    }
+
+    // Trial division stops once p^2 > n, which proves n is 1 or a prime.
+    // It also covers 2, 3, 5 and 7, as needed by the primality test
+    IMATHLIB_STATS_TIMER(trial_division_start);
+    for (const auto& divisor : detail::kTrialDivisorsU32) {
+        if (divisor.prime * divisor.prime > n) {
+            IMATHLIB_STATS_ELAPSED(trial_division_start, trial_division_ns);
+            if (n > 1) result.addFactor({n, 1});
+            return result;
+        }
+        if (static_cast<uint32_t>(n * divisor.inverse) <= divisor.limit) {
+            FactorU32 f{};
+            f.prime = divisor.prime;
+            do {
+                n *= divisor.inverse;
+                ++f.power;
+            } while (static_cast<uint32_t>(n * divisor.inverse) <= divisor.limit);
+            result.addFactor(f);
+            IMATHLIB_STATS_ADD(trial_division_hits, 1);
+        }
+    }
+    IMATHLIB_STATS_ELAPSED(trial_division_start, trial_division_ns);
+
+    if (detail::isPrimeTimed(n)) {
+        result.addFactor({n, 1});
+        return result;
+    }
+
+    // Pollard's Rho algorithm may return a composite divisor,
+    // so we need to keep track of all calculated composite divisors,
+    // together with the powers they occur in.
+    // We only add prime factors to the result
+    uint32_t composite_factors[8]{n, };
+    uint32_t composite_powers[8]{1, };
+    size_t composite_factors_count = 1;
+    uint32_t polynomial_constant = 1;
+
+    while (composite_factors_count > 0) {
+        IMATHLIB_STATS_MAX(max_composite_stack, composite_factors_count);
+        --composite_factors_count;
+        uint32_t cf = composite_factors[composite_factors_count];
+        uint32_t power = composite_powers[composite_factors_count];
+        uint32_t f = 0;
+
+        // Rho is slow for prime powers, and finds only their p^i divisors
+        IMATHLIB_STATS_TIMER(perfect_power_start);
+        auto perfect_power = isPerfectPower(cf);
+        IMATHLIB_STATS_ELAPSED(perfect_power_start, perfect_power_ns);
+        if (perfect_power) {
+            cf = perfect_power.root;
+            power *= perfect_power.exponent;
+            if (detail::isPrimeTimed(cf)) {
+                result.addUnorderedFactor({cf, power});
+                continue;
+            }
+        }
+
+        // Pollard's Rho algorithm might fail to find a divisor,
+        // so retry with different polynomials
+        IMATHLIB_STATS_TIMER(rho_start);
+        do {
+            f = detail::pollardRhoBrent(cf, polynomial_constant++);
+            IMATHLIB_STATS_ADD(rho_retries, f == cf ? 1 : 0);
+        } while (f == cf);
+        IMATHLIB_STATS_ELAPSED(rho_start, rho_ns);
+
+        if (detail::isPrimeTimed(f)) {
+            result.addUnorderedFactor({f, power});
+        } else {
+            composite_factors[composite_factors_count] = f;
+            composite_powers[composite_factors_count++] = power;
+        }
+
+        cf /= f;
+
+        if (detail::isPrimeTimed(cf)) {
+            result.addUnorderedFactor({cf, power});
+        } else {
+            composite_factors[composite_factors_count] = cf;
+            composite_powers[composite_factors_count++] = power;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Composite divisor that a bounded factorization did not factor,
+ * occurring in the factored number in the given power.
+ * */
+struct CofactorU64 {
+    uint64_t value;
+    uint64_t power;
+};
+
+/**
+ * Result of factorizeWithBudget and factorizeWithDeadline: the prime factors
+ * found in time and the composite cofactors that were left. Multiplication
+ * of both gives the original factored number. Without cofactors
+ * the factorization is complete, and primes() is the same as factorize(n).
+ * */
+class PartialFactorizationU64 {
+public:
+    constexpr bool complete() const noexcept {
+        return cofactors_size_ == 0;
+    }
+    constexpr const FactorizationResultU64& primes() const noexcept {
+        return primes_;
+    }
+    constexpr size_t cofactorCount() const noexcept {
+        return cofactors_size_;
+    }
+    constexpr const CofactorU64& cofactor(size_t idx) const {
+        return cofactors_[idx];
+    }
+
+private:
+    /**
+     * Factorization of n, where Pollard's rho walks stop if the limit
+     * does not let them go on, see detail::RhoNoLimit.
+     * */
+    template <typename Limit>
+    static IMATHLIB_CONSTEXPR_X64 PartialFactorizationU64 factorizeLimited(
+        uint64_t n, Limit& limit) noexcept {
+        IMATHLIB_STATS_ADD(factorize_calls, 1);
+        PartialFactorizationU64 partial{};
+        FactorizationResultU64& result = partial.primes_;
+        if (n <= 1) return partial;
+
+        if (n % 2 == 0) {
+            int trailing_zeroes = detail::ctz(n);
+            n >>= trailing_zeroes;
+            result.addFactor({2, static_cast<uint64_t>(trailing_zeroes)});
+        }
+
+        // Trial division stops once p^2 > n, which proves n is 1 or a prime.
+        // It also covers 2, 3, 5 and 7, as needed by the primality test
+        IMATHLIB_STATS_TIMER(trial_division_start);
+        for (const auto& divisor : detail::kTrialDivisorsU64) {
+            if (divisor.prime * divisor.prime > n) {
+                IMATHLIB_STATS_ELAPSED(trial_division_start, trial_division_ns);
+                if (n > 1) result.addFactor({n, 1});
+                return partial;
+            }
+            if (static_cast<uint64_t>(n * divisor.inverse) <= divisor.limit) {
+                FactorU64 f{};
+                f.prime = divisor.prime;
+                do {
+                    n *= divisor.inverse;
+                    ++f.power;
+                } while (static_cast<uint64_t>(n * divisor.inverse) <=
+                         divisor.limit);
+                result.addFactor(f);
+                IMATHLIB_STATS_ADD(trial_division_hits, 1);
+            }
+        }
+        IMATHLIB_STATS_ELAPSED(trial_division_start, trial_division_ns);
+
+        if (detail::isPrimeTimed(n)) {
+            result.addFactor({n, 1});
+            return partial;
+        }
+
+        // Pollard's Rho algorithm may return a composite divisor,
+        // so we need to keep track of all calculated composite divisors,
+        // together with the powers they occur in.
+        // We only add prime factors to the result
+        uint64_t composite_factors[8]{n, };
+        uint64_t composite_powers[8]{1, };
+        size_t composite_factors_count = 1;
+        uint64_t polynomial_constant = 1;
+
+        while (composite_factors_count > 0) {
+            IMATHLIB_STATS_MAX(max_composite_stack, composite_factors_count);
+            --composite_factors_count;
+            uint64_t cf = composite_factors[composite_factors_count];
+            uint64_t power = composite_powers[composite_factors_count];
+            uint64_t f = 0;
+
+            // Rho is slow for prime powers, and finds only their p^i divisors
+            IMATHLIB_STATS_TIMER(perfect_power_start);
+            auto perfect_power = isPerfectPower(cf);
+            IMATHLIB_STATS_ELAPSED(perfect_power_start, perfect_power_ns);
+            if (perfect_power) {
+                cf = perfect_power.root;
+                power *= perfect_power.exponent;
+                if (detail::isPrimeTimed(cf)) {
+                    result.addUnorderedFactor({cf, power});
+                    continue;
+                }
+            }
+
+            // Pollard's Rho algorithm might fail to find a divisor,
+            // so retry with different polynomials
+            IMATHLIB_STATS_TIMER(rho_start);
+            f = detail::rhoDivisor(cf, polynomial_constant, limit);
+            IMATHLIB_STATS_ELAPSED(rho_start, rho_ns);
+
+            if (f == 1) {
+                // Out of limit, so this and all the waiting divisors stay
+                partial.cofactors_[partial.cofactors_size_++] = {cf, power};
+                while (composite_factors_count > 0) {
+                    --composite_factors_count;
+                    partial.cofactors_[partial.cofactors_size_++] = {
+                        composite_factors[composite_factors_count],
+                        composite_powers[composite_factors_count]};
+                }
+                return partial;
+            }
+
+            if (detail::isPrimeTimed(f)) {
+                result.addUnorderedFactor({f, power});
+            } else {
+                composite_factors[composite_factors_count] = f;
+                composite_powers[composite_factors_count++] = power;
+            }
+
+            cf /= f;
+
+            if (detail::isPrimeTimed(cf)) {
+                result.addUnorderedFactor({cf, power});
+            } else {
+                composite_factors[composite_factors_count] = cf;
+                composite_powers[composite_factors_count++] = power;
+            }
+        }
+
+        return partial;
+    }
+
+    FactorizationResultU64 primes_{};
+    CofactorU64 cofactors_[8]{};
+    size_t cofactors_size_{};
+    friend IMATHLIB_CONSTEXPR_X64
+    FactorizationResultU64 factorize(uint64_t n) noexcept;
+    friend IMATHLIB_CONSTEXPR_X64 PartialFactorizationU64 factorizeWithBudget(
+        uint64_t n, uint64_t max_iterations) noexcept;
+    friend PartialFactorizationU64 factorizeWithDeadline(
+        uint64_t n, std::chrono::steady_clock::time_point deadline) noexcept;
+#if IMATHLIB_ENABLE_THREADS
+    friend FactorizationResultU64 factorizeParallel(uint64_t n,
+                                                    unsigned threads) noexcept;
+#endif
+};
+
+IMATHLIB_CONSTEXPR_X64 FactorizationResultU64 factorize(uint64_t n) noexcept {
+    detail::RhoNoLimit limit{};
+    return PartialFactorizationU64::factorizeLimited(n, limit).primes_;
+}
+
+/**
+ * Factorization which stops after about max_iterations steps of Pollard's
+ * rho in total, returning what it found so far. Trial division and
+ * primality tests are not limited, they take a few microseconds at most.
+ * A step is one multiplication modulo n, a few nanoseconds.
+ * */
+IMATHLIB_CONSTEXPR_X64 PartialFactorizationU64 factorizeWithBudget(
+    uint64_t n, uint64_t max_iterations) noexcept {
+    detail::RhoIterationLimit limit{max_iterations};
+    return PartialFactorizationU64::factorizeLimited(n, limit);
+}
+
+/**
+ * Factorization which stops at the deadline, returning what it found so far.
+ * The clock is checked once per 128 steps of Pollard's rho, so the deadline
+ * may pass by about a microsecond, plus the unlimited trial division
+ * and primality tests.
+ * */
+inline PartialFactorizationU64 factorizeWithDeadline(
+    uint64_t n, std::chrono::steady_clock::time_point deadline) noexcept {
+    detail::RhoDeadline limit{deadline};
+    return PartialFactorizationU64::factorizeLimited(n, limit);
+}
+
+#if IMATHLIB_ENABLE_THREADS
+/**
+ * factorize for single hard numbers, with Pollard's rho walks raced
+ * on threads, see detail::rhoDivisor. 0 threads means as many as
+ * the hardware runs at once.
+ * Each composite divisor is first given 2^14 steps on the calling
+ * thread, which is longer than starting the threads takes, so that
+ * numbers with small or medium factors don't pay for them.
+ * The threads are started for each race and joined before it returns,
+ * there is no pool. If they can't be started, the calling thread
+ * does their work.
+ * */
+inline FactorizationResultU64 factorizeParallel(uint64_t n,
+                                                unsigned threads) noexcept {
+    if (threads == 0) threads = std::thread::hardware_concurrency();
+    detail::RhoRace race{threads, uint64_t{1} << 14};
+    return PartialFactorizationU64::factorizeLimited(n, race).primes_;
+}
+#endif
+
+#if IMATHLIB_STATS
+/**
+ * Counters of the calling thread, since its start or the last resetStats.
+ * */
+inline Stats statsSnapshot() noexcept {
+    return detail::threadStats();
+}
+
+inline void resetStats() noexcept {
+    detail::threadStats() = Stats{};
+}
+#endif
+
+/**
+ * Factorizations of all n < N, precomputed at compile time if declared
+ * constexpr, so that there is no initialization at startup.
+ *
+ * Keeps the smallest prime factor of every odd composite number, which
+ * is at most sqrt(N), so a byte is enough for N <= 2^16 and 16 bits
+ * for N <= 2^32. Factorization takes one lookup per prime factor.
+ * Large constexpr tables take long to compile, and may need higher
+ * constexpr limits of the compiler.
+ * */
+template <size_t N>
+class FactorTable {
+public:
+    static_assert(N >= 2, "FactorTable must contain at least 0 and 1");
+    static_assert(N - 1 <= UINT32_MAX, "FactorTable is for 32-bit numbers");
+
+    using Entry = typename std::conditional<(N <= 65536),
+                                            uint8_t, uint16_t>::type;
+
+    constexpr FactorTable() noexcept : smallest_factors_{} {
+        for (size_t p = 3; p <= (N - 1) / p; p += 2) {
+            if (smallest_factors_[p / 2] != 0) continue;
+            for (size_t m = p * p; m < N; m += 2 * p) {
+                if (smallest_factors_[m / 2] == 0) {
+                    smallest_factors_[m / 2] = static_cast<Entry>(p);
+                }
+            }
+        }
+    }
+
+    static constexpr size_t size() noexcept {
+        return N;
+    }
+
+    constexpr uint32_t smallestPrimeFactor(uint32_t n) const {
+        IMATHLIB_ASSERT(1 < n && n < N);
+        if (n % 2 == 0) return 2;
+        uint32_t factor = smallest_factors_[n / 2];
+        return factor != 0 ? factor : n;
+    }
+
+    constexpr bool isPrime(uint32_t n) const {
+        IMATHLIB_ASSERT(n < N);
+        return n > 1 && smallestPrimeFactor(n) == n;
+    }
+
+    constexpr FactorizationResultU32 factorize(uint32_t n) const {
+        IMATHLIB_ASSERT(n < N);
+        FactorizationResultU32 result{};
+        while (n > 1) {
+            FactorU32 f{smallestPrimeFactor(n), 0};
+            do {
+                n /= f.prime;
+                ++f.power;
+            } while (n % f.prime == 0);
+            result.addFactor(f);
+        }
+        return result;
+    }
+
+private:
+    // Odd n at n / 2, 0 for primes
+    Entry smallest_factors_[N / 2];
+};
+
+/**
+ * Fixed-size cache of 64-bit factorizations, for inputs that repeat.
+ * Lookups and insertions are lock-free and may run in many threads at once.
+ *
+ * Open addressing: a number may be stored only in the kProbeWindow slots
+ * after its hash, and when they are all taken, one of them is evicted
+ * with the CLOCK algorithm - slots which were read since the last pass
+ * of the clock hand get a second chance.
+ *
+ * Every slot is a seqlock in its own 64-byte cache line, so threads using
+ * neighbouring slots don't share the lines. Writers claim a slot by making
+ * its version odd, readers copy it and check that the version didn't
+ * change meanwhile, otherwise the slot counts as a miss. Factorizations are
+ * stored compactly: all the primes but the largest are below 2^32,
+ * as the product of two larger ones wouldn't fit in 64 bits.
+ * Numbers with more than kMaxFactors distinct primes are not cached,
+ * trial division finds such factors quickly anyway.
+ * */
+class FactorizationCache {
+public:
+    /**
+     * Capacity is rounded up to a power of two, at least kProbeWindow.
+     * */
+    explicit FactorizationCache(size_t capacity) {
+        size_t rounded = kProbeWindow;
+        while (rounded < capacity) rounded *= 2;
+        capacity_ = rounded;
+        shift_ = detail::clz(uint64_t{rounded}) + 1;
+        // new aligns only to 16 bytes before C++17, so the slots are placed
+        // at a cache line by hand, and no two of them share one
+        size_t space = rounded * sizeof(Slot) + kCacheLine - 1;
+        storage_.reset(new unsigned char[space]);
+        void* aligned = storage_.get();
+        std::align(kCacheLine, rounded * sizeof(Slot), aligned, space);
+        slots_ = static_cast<Slot*>(aligned);
+        for (size_t i = 0; i < rounded; ++i) {
+            new (slots_ + i) Slot();
+        }
+    }
+
+    size_t capacity() const noexcept {
+        return capacity_;
+    }
+    uint64_t hits() const noexcept {
+        return hits_.load(std::memory_order_relaxed);
+    }
+    uint64_t misses() const noexcept {
+        return misses_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * factorize(n), from the cache if possible.
+     * */
+    FactorizationResultU64 factorize(uint64_t n) noexcept {
+        FactorizationResultU64 result{};
+        if (!lookup(n, result)) {
+            result = imath::factorize(n);
+            insert(n, result);
+        }
+        return result;
+    }
+
+    /**
+     * Copies the cached factorization of n to result and returns true,
+     * or returns false and leaves result unchanged.
+     * */
+    bool lookup(uint64_t n, FactorizationResultU64& result) noexcept {
+        size_t home = homeSlot(n);
+        for (size_t i = 0; n > 1 && i < kProbeWindow; ++i) {
+            Slot& slot = slots_[(home + i) & (capacity_ - 1)];
+            uint64_t version = slot.version.load(std::memory_order_acquire);
+            uint64_t key = slot.key.load(std::memory_order_relaxed);
+            if (key == 0) break;
+            if (key != n) continue;
+            uint64_t payload[kPayloadWords]{};
+            for (size_t j = 0; j < kPayloadWords; ++j) {
+                payload[j] = slot.payload[j].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if ((version & 1) != 0 ||
+                slot.version.load(std::memory_order_relaxed) != version) {
+                continue;
+            }
+            if (slot.referenced.load(std::memory_order_relaxed) == 0) {
+                slot.referenced.store(1, std::memory_order_relaxed);
+            }
+            result = decode(payload);
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    /**
+     * Stores result as the factorization of n. Gives up, if another
+     * thread is writing to the chosen slot.
+     * */
+    void insert(uint64_t n, const FactorizationResultU64& result) noexcept {
+        uint64_t payload[kPayloadWords]{};
+        if (n <= 1 || !encode(result, payload)) return;
+
+        size_t home = homeSlot(n);
+        Slot* victim = nullptr;
+        for (size_t i = 0; i < kProbeWindow && victim == nullptr; ++i) {
+            Slot& slot = slots_[(home + i) & (capacity_ - 1)];
+            uint64_t key = slot.key.load(std::memory_order_relaxed);
+            if (key == 0 || key == n) victim = &slot;
+        }
+        // The hand passes all the slots at most twice,
+        // as it clears the reference bits on the way
+        size_t hand = clock_hand_.fetch_add(1, std::memory_order_relaxed);
+        for (size_t i = 0; i < 2 * kProbeWindow && victim == nullptr; ++i) {
+            Slot& slot = slots_[(home + (hand + i) % kProbeWindow) &
+                                (capacity_ - 1)];
+            if (slot.referenced.exchange(0, std::memory_order_relaxed) == 0) {
+                victim = &slot;
+            }
+        }
+        if (victim == nullptr) return;  // readers kept setting the bits
+
+        uint64_t version = victim->version.load(std::memory_order_relaxed);
+        if ((version & 1) != 0 ||
+            !victim->version.compare_exchange_strong(
+                version, version + 1, std::memory_order_relaxed)) {
+            return;
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        victim->key.store(n, std::memory_order_relaxed);
+        for (size_t j = 0; j < kPayloadWords; ++j) {
+            victim->payload[j].store(payload[j], std::memory_order_relaxed);
+        }
+        victim->referenced.store(1, std::memory_order_relaxed);
+        victim->version.store(version + 2, std::memory_order_release);
+    }
+
+private:
+    static constexpr size_t kProbeWindow = 8;
+    static constexpr size_t kMaxFactors = 7;
+    // The largest prime, up to 6 smaller primes, which are all below
+    // 2^32, in pairs, and 7 bytes of powers, the last one of the
+    // largest prime
+    static constexpr size_t kPayloadWords = 5;
+    static constexpr size_t kCacheLine = 64;
+
+    struct alignas(kCacheLine) Slot {
+        std::atomic<uint64_t> version{0};
+        std::atomic<uint64_t> key{0};
+        std::atomic<uint64_t> payload[kPayloadWords]{};
+        std::atomic<uint64_t> referenced{0};
+    };
+    static_assert(sizeof(Slot) == kCacheLine, "Slot must fill a cache line");
+    // The slots are never destroyed, only their storage is freed
+    static_assert(std::is_trivially_destructible<Slot>::value,
+                  "Slot must be trivially destructible");
+
+    size_t homeSlot(uint64_t n) const noexcept {
+        // Fibonacci hashing, the high bits of n * 2^64 / phi
+        return static_cast<size_t>((n * 0x9e3779b97f4a7c15ull) >> shift_);
+    }
+
+    static bool encode(const FactorizationResultU64& result,
+                       uint64_t (&payload)[kPayloadWords]) noexcept {
+        size_t size = result.size();
+        if (size == 0 || size > kMaxFactors) return false;
+        payload[0] = result.back().prime;
+        for (size_t i = 0; i + 1 < size; ++i) {
+            payload[1 + i / 2] |= result[i].prime << (i % 2 * 32);
+            payload[4] |= result[i].power << (i * 8);
+        }
+        payload[4] |= result.back().power << 48;
+        return true;
+    }
+
+    static FactorizationResultU64 decode(
+        const uint64_t (&payload)[kPayloadWords]) noexcept {
+        FactorizationResultU64 result{};
+        for (size_t i = 0; i + 1 < kMaxFactors; ++i) {
+            uint64_t prime = (payload[1 + i / 2] >> (i % 2 * 32)) & 0xffffffff;
+            if (prime == 0) break;
+            result.addFactor({prime, (payload[4] >> (i * 8)) & 0xff});
+        }
+        result.addFactor({payload[0], payload[4] >> 48});
+        return result;
+    }
+
+    std::unique_ptr<unsigned char[]> storage_;
+    Slot* slots_ = nullptr;
+    size_t capacity_ = 0;
+    int shift_ = 0;
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<size_t> clock_hand_{0};
+};
+
+constexpr uint32_t pow(uint32_t n, uint32_t pow) noexcept {
+    uint32_t result = 1;
+    while (pow) {
+        if (pow & 1) result *= n;
+        n *= n;
+        pow >>= 1;
+    }
+    return result;
+}
+constexpr uint64_t pow(uint64_t n, uint64_t pow) noexcept {
+    uint64_t result = 1;
+    while (pow) {
+        if (pow & 1) result *= n;
+        n *= n;
+        pow >>= 1;
+    }
+    return result;
+}
+
+constexpr uint32_t mulmod(uint32_t a, uint32_t b, uint32_t mod) {
+    IMATHLIB_ASSERT(mod > 0);
+    return static_cast<uint32_t>((uint64_t{a} * b) % mod);
+}
+IMATHLIB_CONSTEXPR_X64
+uint64_t mulmod(uint64_t a, uint64_t b, uint64_t mod) {
+    IMATHLIB_ASSERT(mod > 0);
+    if ((mod & (mod - 1)) == 0) {  // is power of two
+        return (a * b) & (mod - 1);
+    }
+    // Common in hashing, and folding is much faster than the division.
+    // Only for a modulus known to the compiler, where the check is free,
+    // callers with it at runtime use mulmodMersenne61
+    if (IMATHLIB_KNOWN_CONSTANT(mod) && mod == (uint64_t{1} << 61) - 1) {
+        return mulmodMersenne61(a, b);
+    }
+
+    detail::u128 x = detail::mul64x64(a, b);
+    if (x.hi >= mod) {
+        x.hi %= mod;
+    }
+    if (x.hi == 0) {
+        return x.lo % mod;
+    }
+
+    return detail::mod128by64(x, mod);
+}
+
+/**
+ * n^pow modulo mod. Odd moduli use Montgomery multiplication,
+ * unless pow is small, or the compiler knows mod and divides by it
+ * with a multiplication, which is faster still.
+ * */
+constexpr uint32_t powmod(uint32_t n, uint32_t pow, uint32_t mod) {
+    IMATHLIB_ASSERT(mod > 0);
+    if ((mod & 1) != 0 && (pow >> detail::kPowmodMontgomeryBits) != 0 &&
+        !IMATHLIB_KNOWN_CONSTANT(mod)) {
+        return detail::powmodMontgomery(n, pow, mod);
+    }
+    uint32_t cur = n;
+    uint32_t res = 1;
+    while (pow) {
+        if (pow & 1) res = mulmod(cur, res, mod);
+        cur = mulmod(cur, cur, mod);
+        pow >>= 1;
+    }
+    return res;
+}
+IMATHLIB_CONSTEXPR_X64
+uint64_t powmod(uint64_t n, uint64_t pow, uint64_t mod) {
+    IMATHLIB_ASSERT(mod > 0);
+    if ((mod & 1) != 0 && (pow >> detail::kPowmodMontgomeryBits) != 0 &&
+        !(IMATHLIB_KNOWN_CONSTANT(mod) && mod >> 32 == 0)) {
+        return detail::powmodMontgomery(n, pow, mod);
+    }
+    uint64_t cur = n;
+    uint64_t res = 1;
+    while (pow) {
+        if (pow & 1) res = mulmod(cur, res, mod);
+        cur = mulmod(cur, cur, mod);
+        pow >>= 1;
+    }
+    return res;
+}
+
+/**
+ * n^E modulo mod, with the exponent known at compile time.
+ * The exponentiation is unrolled, so there is no loop and no branch on
+ * the bits of E, and the zero bits cost only the squaring. The chain is
+ * square and multiply rather than an optimal addition chain, see
+ * detail::PowChain.
+ * Useful for fixed exponents, like Fermat's inverse powmod<P - 2>(n, P).
+ * */
+template <uint64_t E>
+constexpr uint32_t powmod(uint32_t n, uint32_t mod) {
+    IMATHLIB_ASSERT(mod > 0);
+    return detail::powmodChain<E>(n % mod, mod);
+}
+
+template <uint64_t E>
+IMATHLIB_CONSTEXPR_X64 uint64_t powmod(uint64_t n, uint64_t mod) {
+    IMATHLIB_ASSERT(mod > 0);
+    return detail::powmodChain<E>(n % mod, mod);
+}
+
+/**
+ * bases[i]^pow modulo mod for count bases, into out, which can be bases.
+ * For odd moduli, groups of bases share the loop over the bits of pow,
+ * and their independent multiplications overlap.
+ * */
+IMATHLIB_CONSTEXPR_X64 void powmodMulti(const uint64_t* bases, size_t count,
+                                        uint64_t pow, uint64_t mod,
+                                        uint64_t* out) {
+    IMATHLIB_ASSERT(mod > 0);
+    size_t i = 0;
+    if ((mod & 1) != 0 && (pow >> detail::kPowmodMontgomeryBits) != 0) {
+        // The last base alone runs faster in powmod
+        for (; i + 1 < count; i += detail::kPowmodLanes) {
+            size_t lanes = detail::min(count - i, detail::kPowmodLanes);
+            detail::powmodMontgomeryLanes(bases + i, lanes, pow, mod, out + i);
+        }
+    }
+    for (; i < count; ++i) {
+        out[i] = powmod(bases[i], pow, mod);
+    }
+}
+
+/**
+ * a^x * b^y modulo mod, faster than two powmods.
+ * For odd moduli both powers are computed in one loop, see
+ * detail::powmod2Montgomery.
+ * */
+constexpr uint32_t powmod2(uint32_t a, uint32_t x, uint32_t b, uint32_t y,
+                           uint32_t mod) {
+    IMATHLIB_ASSERT(mod > 0);
+    if ((mod & 1) != 0 && ((x | y) >> detail::kPowmodMontgomeryBits) != 0) {
+        return detail::powmod2Montgomery(a, x, b, y, mod);
+    }
+    return mulmod(powmod(a, x, mod), powmod(b, y, mod), mod);
+}
+
+IMATHLIB_CONSTEXPR_X64 uint64_t powmod2(uint64_t a, uint64_t x, uint64_t b,
+                                        uint64_t y, uint64_t mod) {
+    IMATHLIB_ASSERT(mod > 0);
+    if ((mod & 1) != 0 && ((x | y) >> detail::kPowmodMontgomeryBits) != 0) {
+        return detail::powmod2Montgomery(a, x, b, y, mod);
+    }
+    return mulmod(powmod(a, x, mod), powmod(b, y, mod), mod);
+}
+
+/**
+ * Multiplication by a fixed b modulo a fixed mod < 2^63 (Shoup's trick).
+ * With b' = floor(b * 2^64 / mod) precomputed, q = floor(a * b' / 2^64)
+ * is floor(a * b / mod) or one less, so a * b - q * mod, which can be
+ * computed modulo 2^64, is in [0, 2 * mod). That is two multiplications
+ * and a conditional subtraction, with no division, for any 64-bit a.
+ * */
+class MulModPrecomp {
+public:
+    IMATHLIB_CONSTEXPR_X64 MulModPrecomp(uint64_t b, uint64_t mod)
+        : b_{b % mod},
+          b_shoup_{detail::div128by64(detail::u128{b % mod, 0}, mod)},
+          mod_{mod} {
+        IMATHLIB_ASSERT(mod >> 63 == 0);
+    }
+
+    constexpr uint64_t multiplier() const noexcept {
+        return b_;
+    }
+    constexpr uint64_t modulo() const noexcept {
+        return mod_;
+    }
+
+    /**
+     * a * b mod m.
+     * */
+    IMATHLIB_CONSTEXPR_X64 uint64_t mul(uint64_t a) const noexcept {
+        uint64_t r = mulLazy(a);
+        return r >= mod_ ? r - mod_ : r;
+    }
+
+    /**
+     * a * b mod m or a * b mod m + m, for a chain of operations,
+     * which can postpone the final reduction.
+     * */
+    IMATHLIB_CONSTEXPR_X64 uint64_t mulLazy(uint64_t a) const noexcept {
+        uint64_t q = detail::mul64x64(a, b_shoup_).hi;
+        return a * b_ - q * mod_;
+    }
+
+private:
+    uint64_t b_;
+    uint64_t b_shoup_;
+    uint64_t mod_;
+};
+
+/**
+ * out[i] = numbers[i] * b mod m. Out may be the same array as numbers.
+ * */
+IMATHLIB_CONSTEXPR_X64 void mulmod(const uint64_t* numbers, size_t count,
+                                   const MulModPrecomp& b, uint64_t* out) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = b.mul(numbers[i]);
+    }
+}
+
+/**
+ * out[i] = numbers[i] * b mod m. Out may be the same array as numbers.
+ * Uses MulModPrecomp when mod < 2^63, one division pays off quickly.
+ * */
+IMATHLIB_CONSTEXPR_X64 void mulmod(const uint64_t* numbers, size_t count,
+                                   uint64_t b, uint64_t mod, uint64_t* out) {
+    IMATHLIB_ASSERT(mod > 0);
+    if (mod >> 63 != 0 || count < 2) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = mulmod(numbers[i], b, mod);
+        }
+        return;
+    }
+    mulmod(numbers, count, MulModPrecomp{b, mod}, out);
+}
+
+/**
+ * a * b mod 2^61 - 1, for any a and b, with no division.
+ * 2^61 = 1 modulo 2^61 - 1, so the 128-bit product is split into 61-bit
+ * chunks, which are added, and the sum below 2^63 is folded once more.
+ * mulmod uses it for this modulus, when the compiler knows it.
+ * */
+IMATHLIB_CONSTEXPR_X64 uint64_t mulmodMersenne61(uint64_t a,
+                                                 uint64_t b) noexcept {
+    constexpr uint64_t kMod = (uint64_t{1} << 61) - 1;
+    detail::u128 x = detail::mul64x64(a, b);
+    uint64_t sum = (x.lo & kMod) + (((x.lo >> 61) | (x.hi << 3)) & kMod) +
+                   (x.hi >> 58);
+    sum = (sum & kMod) + (sum >> 61);
+    return sum >= kMod ? sum - kMod : sum;
+}
+
+/**
+ * out[i] = numbers[i] * b mod 2^61 - 1. Out may be the same array as numbers.
+ * */
+IMATHLIB_CONSTEXPR_X64 void mulmodMersenne61(const uint64_t* numbers,
+                                             size_t count, uint64_t b,
+                                             uint64_t* out) noexcept {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = mulmodMersenne61(numbers[i], b);
+    }
+}
+
+/**
+ * Multiplication modulo 2^64 - C for 0 < C < 2^32, with no division:
+ * the high word of the product is multiplied by C and added to the low one.
+ * It pays off where 128 by 64 bit division is slow or missing. On recent
+ * x86_64 CPUs divq is as fast, so mulmod keeps dividing by such moduli.
+ * */
+template <uint64_t C>
+class PseudoMersenne {
+public:
+    static_assert(C > 0 && C >> 32 == 0,
+                  "PseudoMersenne is available for 0 < C < 2^32");
+
+    static constexpr uint64_t modulo() noexcept {
+        return 0 - C;
+    }
+
+    /**
+     * a * b mod 2^64 - C, for any a and b.
+     * */
+    static IMATHLIB_CONSTEXPR_X64 uint64_t mul(uint64_t a,
+                                               uint64_t b) noexcept {
+        return detail::mulmodPseudoMersenne(a, b, C);
+    }
+
+    /**
+     * out[i] = numbers[i] * b mod 2^64 - C.
+     * Out may be the same array as numbers.
+     * */
+    static IMATHLIB_CONSTEXPR_X64 void mul(const uint64_t* numbers,
+                                           size_t count, uint64_t b,
+                                           uint64_t* out) noexcept {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = detail::mulmodPseudoMersenne(numbers[i], b, C);
+        }
+    }
+
+    /**
+     * n mod 2^64 - C.
+     * */
+    static constexpr uint64_t reduce(uint64_t n) noexcept {
+        return n >= modulo() ? n - modulo() : n;
+    }
+};
+
+IMATHLIB_CONSTEXPR_INTR uint32_t gcd(uint32_t a, uint32_t b) noexcept {
+    if (IMATHLIB_IS_CONSTEVAL) {
+        return detail::gcdModuloRecursive(a, b);
+    }
+
+#if defined(IMATHLIB_FAST_CTZ32)
+    return detail::gcdBinary(a, b);
+#else
+    return detail::gcdModuloRecursive(a, b);
+#endif
+}
+
+IMATHLIB_CONSTEXPR_INTR uint64_t gcd(uint64_t a, uint64_t b) noexcept {
+    if (IMATHLIB_IS_CONSTEVAL) {
+        return detail::gcdModuloRecursive(a, b);
+    }
+
+#if defined(IMATHLIB_FAST_CTZ64)
+    return detail::gcdBinary(a, b);
+#else
+    return detail::gcdModuloRecursive(a, b);
+#endif
+}
+
+IMATHLIB_CONSTEXPR_INTR uint32_t lcm(uint32_t a, uint32_t b) noexcept {
+    return a / gcd (a, b) * b;
+}
+
+IMATHLIB_CONSTEXPR_INTR uint64_t lcm(uint64_t a, uint64_t b) noexcept {
+    return a / gcd (a, b) * b;
+}
+
+/**
+ * GCD of all the numbers, 0 for an empty range.
+ * Stops as soon as the result is 1.
+ * */
+IMATHLIB_CONSTEXPR_INTR uint32_t gcdReduce(const uint32_t* numbers,
+                                           size_t count) noexcept {
+    uint32_t result = 0;
+    for (size_t i = 0; i < count && result != 1; ++i) {
+        result = gcd(result, numbers[i]);
+    }
+    return result;
+}
+
+IMATHLIB_CONSTEXPR_INTR uint64_t gcdReduce(const uint64_t* numbers,
+                                           size_t count) noexcept {
+    uint64_t result = 0;
+    for (size_t i = 0; i < count && result != 1; ++i) {
+        result = gcd(result, numbers[i]);
+    }
+    return result;
+}
+
+/**
+ * LCM of all the numbers, 1 for an empty range.
+ * Returns 0 if the result doesn't fit in 32 bits
+ * (or if any of the numbers is 0, as lcm(0, n) = 0).
+ * */
+IMATHLIB_CONSTEXPR_INTR uint32_t lcmReduce(const uint32_t* numbers,
+                                           size_t count) noexcept {
+    uint32_t result = 1;
+    for (size_t i = 0; i < count; ++i) {
+        if (numbers[i] == 0) return 0;
+        uint32_t factor = numbers[i] / gcd(result, numbers[i]);
+        if (result > UINT32_MAX / factor) return 0;
+        result *= factor;
+    }
+    return result;
+}
+
+/**
+ * LCM of all the numbers, 1 for an empty range.
+ * Returns 0 if the result doesn't fit in 64 bits
+ * (or if any of the numbers is 0, as lcm(0, n) = 0).
+ * */
+IMATHLIB_CONSTEXPR_INTR uint64_t lcmReduce(const uint64_t* numbers,
+                                           size_t count) noexcept {
+    uint64_t result = 1;
+    for (size_t i = 0; i < count; ++i) {
+        if (numbers[i] == 0) return 0;
+        uint64_t factor = numbers[i] / gcd(result, numbers[i]);
+        if (result > UINT64_MAX / factor) return 0;
+        result *= factor;
+    }
+    return result;
+}
+
+/**
+ * Elementwise GCD, out[i] = gcd(a[i], b[i]).
+ * Calculates a few GCDs at once, interleaved or with AVX2 if the CPU has it,
+ * to hide the latency of binary GCD steps.
+ * */
+inline void gcd(const uint32_t* a, const uint32_t* b, size_t count,
+                uint32_t* out) noexcept {
+    size_t interleaved = 0;
+#if defined(IMATHLIB_FAST_CTZ32)
+    interleaved = count / 4 * 4;
+    for (size_t i = 0; i < interleaved; i += 4) {
+        detail::gcdBinaryInterleaved(a + i, b + i, out + i);
+    }
+#endif
+    for (size_t i = interleaved; i < count; ++i) {
+        out[i] = gcd(a[i], b[i]);
+    }
+}
+
+inline void gcd(const uint64_t* a, const uint64_t* b, size_t count,
+                uint64_t* out) noexcept {
+    size_t interleaved = 0;
+#if IMATHLIB_AVX2_KERNELS
+    if (detail::hasAvx2()) {
+        interleaved = detail::gcdAvx2(a, b, count, out);
+    }
+#endif
+#if defined(IMATHLIB_FAST_CTZ64)
+    if (interleaved == 0) {
+        interleaved = count / 4 * 4;
+        for (size_t i = 0; i < interleaved; i += 4) {
+            detail::gcdBinaryInterleaved(a + i, b + i, out + i);
+        }
+    }
+#endif
+    for (size_t i = interleaved; i < count; ++i) {
+        out[i] = gcd(a[i], b[i]);
+    }
 }
 
-IMATHLIB_CONSTEXPR_X64 bool isPrime(uint64_t n) noexcept {
-    if (n < (1ull << 32)) return isPrime(static_cast<uint32_t>(n));
-    if (n % 2 == 0 || n % 3 == 0 || n % 5 == 0 || n % 7 == 0) return false;
+/**
+ * Result of the extended Euclidean algorithm: a * x + b * y = gcd.
+ * Coefficients are the minimal ones, |x| <= max(1, b / (2 * gcd)) and
+ * |y| <= max(1, a / (2 * gcd)), so they always fit in the signed types.
+ * */
+struct ExtendedGcdU32 {
+    uint32_t gcd;
+    int32_t x;
+    int32_t y;
+};
 
-    if (!detail::isSPRP(n, 2)) return false;
+struct ExtendedGcdU64 {
+    uint64_t gcd;
+    int64_t x;
+    int64_t y;
+};
 
-    // Steve Worley, 2013
-    if (n < 109134866497)
-        return detail::isSPRP(n, 1005905886) &&
-               detail::isSPRP(n, 1340600841);
+constexpr ExtendedGcdU32 extendedGcd(uint32_t a, uint32_t b) noexcept {
+    return detail::extendedEuclid<uint32_t, ExtendedGcdU32>(a, b);
+}
 
-    if (n < 55245642489451)
-        return detail::isSPRP(n, 141889084524735) &&
-               detail::isSPRP(n, 1199124725622454117) &&
-               detail::isSPRP(n, 11096072698276303650u);
+constexpr ExtendedGcdU64 extendedGcd(uint64_t a, uint64_t b) noexcept {
+    return detail::extendedEuclid<uint64_t, ExtendedGcdU64>(a, b);
+}
 
-    uint64_t h = n;
-    h = ((h >> 32) ^ h) * 0x123456789abce1b;
-    h = ((h >> 32) ^ h) * 0x123456789abce1b;
-    h = ((h >> 32) ^ h) & 127;
+/**
+ * Returns x in [0, mod) such that n * x = 1 (mod mod),
+ * or 0 if n and mod are not coprime.
+ * Unlike powmod(n, mod - 2, mod), it works for any modulo, not only primes.
+ * Odd modulos use the binary extended GCD, even ones the Euclidean algorithm.
+ * Note, that for mod = 1 the result is 0, which is also a correct inverse.
+ * */
+IMATHLIB_CONSTEXPR_INTR uint32_t modInverse(uint32_t n, uint32_t mod) {
+    IMATHLIB_ASSERT(mod > 0);
+#if defined(IMATHLIB_FAST_CTZ32)
+    if (mod & 1) return detail::modInverseBinary<uint32_t>(n, mod);
+#endif
+    return detail::modInverseEuclid<uint32_t, ExtendedGcdU32>(n, mod);
+}
 
-    uint32_t bs = detail::bases_prime_test_u64[h];
-    // see comments above detail::bases_prime_test_u64 for details
-    auto b1 = 15u;
-    auto b2 = (bs >> 22) & 0x3FF;
-    auto b3 = (bs >> 11) & 0x7FF;
-    auto b4 = (bs >> 0) & 0x7FF;
-    return detail::isSPRP(n, uint64_t{b1}) &&
-           detail::isSPRP(n, uint64_t{b2}) &&
-           detail::isSPRP(n, uint64_t{b3}) &&
-           detail::isSPRP(n, uint64_t{b4});
+IMATHLIB_CONSTEXPR_X64 uint64_t modInverse(uint64_t n, uint64_t mod) {
+    IMATHLIB_ASSERT(mod > 0);
+#if defined(IMATHLIB_FAST_CTZ64)
+    if (mod & 1) return detail::modInverseBinary<uint64_t>(n, mod);
+#endif
+    return detail::modInverseEuclid<uint64_t, ExtendedGcdU64>(n, mod);
 }
 
-IMATHLIB_CONSTEXPR_INTR uint32_t nextPrimeAfter(uint32_t n) {
-    IMATHLIB_ASSERT(n < 4294967291u);
-    if (n < 2) return 2;
-    for (n = n + 1 + (n & 1); !isPrime(n); n += 2);
-    return n;
+/**
+ * Elementwise modular inverse, out[i] = modInverse(numbers[i], mod).
+ * Uses Montgomery's trick: a single inversion of the product of all
+ * the numbers, and 3 * (count - 1) modular multiplications.
+ * If any of the numbers is not invertible, so is the product - then
+ * all the numbers are inverted one by one, and such ones get 0.
+ * out must not overlap with numbers.
+ * */
+IMATHLIB_CONSTEXPR_INTR void modInverse(const uint32_t* numbers, size_t count,
+                                        uint32_t mod, uint32_t* out) {
+    IMATHLIB_ASSERT(mod > 0);
+    if (count == 0) return;
+
+    // out[i] = numbers[0] * ... * numbers[i - 1], out[0] = 1
+    uint32_t product = 1 % mod;
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t number = numbers[i];
+        out[i] = product;
+        product = mulmod(product, number, mod);
+    }
+
+    uint32_t inverse = modInverse(product, mod);
+    if (inverse == 0 && mod != 1) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = modInverse(numbers[i], mod);
+        }
+        return;
+    }
+
+    // inverse = 1 / (numbers[0] * ... * numbers[i])
+    for (size_t i = count; i-- > 0;) {
+        uint32_t number = numbers[i];
+        out[i] = mulmod(inverse, out[i], mod);
+        inverse = mulmod(inverse, number, mod);
+    }
 }
-IMATHLIB_CONSTEXPR_X64 uint64_t nextPrimeAfter(uint64_t n) {
-    IMATHLIB_ASSERT(n < 18446744073709551557ull);
-    if (n < 4294967291u) {  // biggest 32-bit prime
-        return nextPrimeAfter(static_cast<uint32_t>(n));
+
+IMATHLIB_CONSTEXPR_X64 void modInverse(const uint64_t* numbers, size_t count,
+                                       uint64_t mod, uint64_t* out) {
+    IMATHLIB_ASSERT(mod > 0);
+    if (count == 0) return;
+
+    // out[i] = numbers[0] * ... * numbers[i - 1], out[0] = 1
+    uint64_t product = 1 % mod;
+    for (size_t i = 0; i < count; ++i) {
+        uint64_t number = numbers[i];
+        out[i] = product;
+        product = mulmod(product, number, mod);
+    }
+
+    uint64_t inverse = modInverse(product, mod);
+    if (inverse == 0 && mod != 1) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = modInverse(numbers[i], mod);
+        }
+        return;
+    }
+
+    // inverse = 1 / (numbers[0] * ... * numbers[i])
+    for (size_t i = count; i-- > 0;) {
+        uint64_t number = numbers[i];
+        out[i] = mulmod(inverse, out[i], mod);
+        inverse = mulmod(inverse, number, mod);
     }
-    for (n = n + 1 + (n & 1); !isPrime(n); n += 2);
-    return n;
 }
 
-// TODO add Montgomery multiplication
+/**
+ * Residue modulo M, which is known at compile time, so that all
+ * the reduction constants are computed by the compiler.
+ * The reduction depends on the form of M (see detail::modIntReduction):
+ * - 2^k is a mask,
+ * - 2^k - 1 (Mersenne) and 2^64 - c with c < 2^32 (pseudo-Mersenne)
+ *   fold the high bits of the product into the low ones,
+ * - other odd M >= 2^32 use Montgomery multiplication,
+ *   and the value is kept in Montgomery form,
+ * - the rest use the reciprocal of M, like Barrett reduction. For M < 2^32
+ *   the product fits in 64 bits, and the compiler does that for % M,
+ *   with a shorter dependency chain than 32-bit Montgomery multiplication.
+ * */
+template <uint64_t M>
+class ModInt {
+public:
+    static_assert(M > 0, "ModInt modulo must be positive");
 
-struct FactorU32 {
-    uint32_t prime;
-    uint32_t power;
+    constexpr ModInt() noexcept = default;
+
+    IMATHLIB_CONSTEXPR_X64 explicit ModInt(uint64_t n) noexcept
+        : value_{toForm(n % M)} {}
+
+    static constexpr uint64_t modulo() noexcept {
+        return M;
+    }
+
+    /**
+     * The residue in [0, M).
+     * */
+    IMATHLIB_CONSTEXPR_X64 uint64_t value() const noexcept {
+        return fromForm(value_);
+    }
+
+    IMATHLIB_CONSTEXPR_X64 ModInt& operator+=(ModInt other) noexcept {
+        uint64_t sum = value_ + other.value_;
+        value_ = (sum < value_ || sum >= M) ? sum - M : sum;
+        return *this;
+    }
+
+    IMATHLIB_CONSTEXPR_X64 ModInt& operator-=(ModInt other) noexcept {
+        value_ = value_ - other.value_ + (value_ < other.value_ ? M : 0);
+        return *this;
+    }
+
+    IMATHLIB_CONSTEXPR_X64 ModInt& operator*=(ModInt other) noexcept {
+        value_ = mulReduce(value_, other.value_);
+        return *this;
+    }
+
+    IMATHLIB_CONSTEXPR_X64 ModInt operator-() const noexcept {
+        return ModInt{} - *this;
+    }
+
+    friend IMATHLIB_CONSTEXPR_X64 ModInt operator+(ModInt a,
+                                                   ModInt b) noexcept {
+        return a += b;
+    }
+
+    friend IMATHLIB_CONSTEXPR_X64 ModInt operator-(ModInt a,
+                                                   ModInt b) noexcept {
+        return a -= b;
+    }
+
+    friend IMATHLIB_CONSTEXPR_X64 ModInt operator*(ModInt a,
+                                                   ModInt b) noexcept {
+        return a *= b;
+    }
+
+    friend constexpr bool operator==(ModInt a, ModInt b) noexcept {
+        return a.value_ == b.value_;
+    }
+
+    friend constexpr bool operator!=(ModInt a, ModInt b) noexcept {
+        return a.value_ != b.value_;
+    }
+
+    /**
+     * this^exponent, with 0^0 = 1.
+     * */
+    IMATHLIB_CONSTEXPR_X64 ModInt pow(uint64_t exponent) const noexcept {
+        ModInt result = one();
+        ModInt base = *this;
+        while (exponent) {
+            if (exponent & 1) result *= base;
+            base *= base;
+            exponent >>= 1;
+        }
+        return result;
+    }
+
+    /**
+     * x such that this * x = 1, or 0 if the value and M are not coprime.
+     * */
+    IMATHLIB_CONSTEXPR_X64 ModInt inverse() const noexcept {
+        return ModInt{modInverse(value(), M)};
+    }
+
+private:
+    static constexpr detail::ModIntReduction kReduction =
+        detail::modIntReduction(M);
+    static constexpr int kShift = detail::clzFallback(M);
+    static constexpr uint64_t kNormalized = M << kShift;
+    // M^-1 mod 2^64
+    static constexpr uint64_t kInverse =
+        kReduction == detail::ModIntReduction::kMontgomery
+            ? detail::inverseModPow2(M) : 0;
+    // R^2 mod M, for the conversion to Montgomery form
+    static constexpr uint64_t kR2 =
+        kReduction == detail::ModIntReduction::kMontgomery
+            ? detail::pow2ModSlow(128, M) : 0;
+    // floor((2^128 - 1) / (M << kShift)) - 2^64
+    static constexpr uint64_t kReciprocal =
+        kReduction == detail::ModIntReduction::kBarrett && M >> 32 != 0
+            ? detail::div128by64Schoolbook(
+                  detail::u128{~kNormalized, ~uint64_t{0}}, kNormalized)
+            : 0;
+
+    static IMATHLIB_CONSTEXPR_X64 uint64_t mulReduce(uint64_t a,
+                                                     uint64_t b) noexcept {
+        if (kReduction == detail::ModIntReduction::kPowerOfTwo) {
+            return (a * b) & (M - 1);
+        }
+        if (kReduction == detail::ModIntReduction::kMersenne) {
+            return detail::mulmodMersenne(a, b, 64 - kShift);
+        }
+        if (kReduction == detail::ModIntReduction::kPseudoMersenne) {
+            return detail::mulmodPseudoMersenne(a, b, 0 - M);
+        }
+        if (kReduction == detail::ModIntReduction::kMontgomery) {
+            return detail::montgomeryMul(a, b, M, kInverse);
+        }
+        if (M >> 32 == 0) {
+            return (a * b) % M;
+        }
+        // a * b < M^2, so the high half is below M, and after the shift
+        // below kNormalized. (x >> 1) >> (63 - kShift) avoids shift by 64
+        detail::u128 x = detail::mul64x64(a, b);
+        detail::u128 shifted{
+            (x.hi << kShift) | ((x.lo >> 1) >> (63 - kShift)),
+            x.lo << kShift};
+        return detail::mod128by64Normalized(shifted, kNormalized,
+                                            kReciprocal) >> kShift;
+    }
+
+    static IMATHLIB_CONSTEXPR_X64 uint64_t toForm(uint64_t n) noexcept {
+        return kReduction == detail::ModIntReduction::kMontgomery
+                   ? mulReduce(n, kR2) : n;
+    }
+
+    static IMATHLIB_CONSTEXPR_X64 uint64_t fromForm(uint64_t n) noexcept {
+        return kReduction == detail::ModIntReduction::kMontgomery
+                   ? mulReduce(n, 1) : n;
+    }
+
+    static IMATHLIB_CONSTEXPR_X64 ModInt one() noexcept {
+        return ModInt{1};
+    }
+
+    uint64_t value_ = 0;
 };
 
 /**
- * Stores results of a 32-bit number factorization.
- * Results are in a form of pairs {prime, power}. Primes are in ascending order.
- * Multiplication of all pairs [i].prime ** [i].power will give the original
- * factored number.
+ * hi * 2^64 + lo, a 128-bit result of CrtBasis::reconstructU128.
  * */
-class FactorizationResultU32 {
+struct CrtU128 {
+    uint64_t hi;
+    uint64_t lo;
+};
+
+/**
+ * Chinese Remainder Theorem for a fixed set of pairwise coprime moduli.
+ * Reconstructs x from its residues x mod moduli[i] with Garner's algorithm,
+ * the unique x in [0, M), where M is the product of all the moduli.
+ * The result is returned modulo 2^64 or 2^128 - exact, if M fits.
+ *
+ * Modular inverses of partial products m[0] * ... * m[i - 1] mod m[i],
+ * and such partial products modulo each m[i] are precomputed, so
+ * reconstruction takes SIZE * (SIZE - 1) / 2 + SIZE - 1 mulmods.
+ * */
+template <size_t SIZE>
+class CrtBasis {
 public:
+    static_assert(SIZE > 0, "Empty CrtBasis is not allowed");
+
+    /**
+     * Moduli must be greater than 1 and pairwise coprime.
+     * */
+    IMATHLIB_CONSTEXPR_X64
+    explicit CrtBasis(const uint64_t (&moduli)[SIZE]) noexcept {
+        for (size_t i = 0; i < SIZE; ++i) {
+            moduli_[i] = moduli[i];
+        }
+        precompute();
+    }
+
+    /**
+     * Basis of SIZE consecutive primes greater than n.
+     * */
+    static IMATHLIB_CONSTEXPR_X64 CrtBasis primesAfter(uint64_t n) noexcept {
+        CrtBasis basis{};
+        for (size_t i = 0; i < SIZE; ++i) {
+            n = nextPrimeAfter(n);
+            basis.moduli_[i] = n;
+        }
+        basis.precompute();
+        return basis;
+    }
+
     constexpr size_t size() const noexcept {
-        return size_;
+        return SIZE;
     }
-    constexpr const FactorU32* begin() const noexcept {
-        return factors_;
+    constexpr const uint64_t* begin() const noexcept {
+        return moduli_;
     }
-    constexpr const FactorU32* end() const noexcept {
-        return factors_ + size_;
+    constexpr const uint64_t* end() const noexcept {
+        return moduli_ + SIZE;
     }
-    constexpr const FactorU32& operator[](size_t idx) const {
-        return factors_[idx];
+    constexpr const uint64_t& operator[](size_t idx) const {
+        return moduli_[idx];
     }
-    constexpr const FactorU32& back() const {
-        return factors_[size_ - 1];
+
+    /**
+     * x mod 2^64 for x = residues[i] (mod moduli[i]), 0 <= x < M.
+     * */
+    IMATHLIB_CONSTEXPR_X64
+    uint64_t reconstruct(const uint64_t* residues) const noexcept {
+        uint64_t digits[SIZE]{};
+        mixedRadixDigits(residues, digits);
+        // Horner's scheme in the mixed radix m[0], m[0] * m[1], ...
+        uint64_t result = digits[SIZE - 1];
+        for (size_t i = SIZE - 1; i-- > 0;) {
+            result = result * moduli_[i] + digits[i];
+        }
+        return result;
     }
 
-private:
     /**
-     * Used to add prime factors found in incresing order using trialdivision
+     * x mod 2^128 for x = residues[i] (mod moduli[i]), 0 <= x < M.
      * */
-    constexpr void addFactor(FactorU32 f) {
-        factors_[size_++] = f;
+    IMATHLIB_CONSTEXPR_X64
+    CrtU128 reconstructU128(const uint64_t* residues) const noexcept {
+        uint64_t digits[SIZE]{};
+        mixedRadixDigits(residues, digits);
+        CrtU128 result{0, digits[SIZE - 1]};
+        for (size_t i = SIZE - 1; i-- > 0;) {
+            detail::u128 low = detail::mul64x64(result.lo, moduli_[i]);
+            result.hi = result.hi * moduli_[i] + low.hi;
+            result.lo = low.lo + digits[i];
+            result.hi += result.lo < low.lo;
+        }
+        return result;
     }
 
     /**
-     * Used to add prime factors found in not specified order.
-     * Performs a linear search to find if the prime factor already occured.
-     * Then either adds power to the existing factor, or performs insertion.
+     * Reconstructs count numbers, residues of the k-th one are
+     * residues[k * SIZE], ..., residues[k * SIZE + SIZE - 1].
      * */
-    constexpr void addUnorderedFactor(FactorU32 f) {
-        size_t i = 0;
-        for (; i < size_ && factors_[i].prime < f.prime; ++i);
-        if (factors_[i].prime == f.prime) {
-            factors_[i].power += f.power;
-            return;
+    IMATHLIB_CONSTEXPR_X64
+    void reconstruct(const uint64_t* residues, size_t count,
+                     uint64_t* out) const noexcept {
+        for (size_t k = 0; k < count; ++k) {
+            out[k] = reconstruct(residues + k * SIZE);
         }
-        // if not found, perform an insertion
-        FactorU32 swapper = f;
-        for (; i < size_; ++i) {
-            detail::simpleSwap(swapper, factors_[i]);
+    }
+
+    IMATHLIB_CONSTEXPR_X64
+    void reconstructU128(const uint64_t* residues, size_t count,
+                         CrtU128* out) const noexcept {
+        for (size_t k = 0; k < count; ++k) {
+            out[k] = reconstructU128(residues + k * SIZE);
         }
-        factors_[size_++] = swapper;
     }
 
-    FactorU32 factors_[10]{};
-    size_t size_{};
-    friend IMATHLIB_CONSTEXPR_INTR
-    FactorizationResultU32 factorize(uint32_t n) noexcept;
-};
+private:
+    constexpr CrtBasis() noexcept = default;
+
+    IMATHLIB_CONSTEXPR_X64 void precompute() noexcept {
+        for (size_t i = 0; i < SIZE; ++i) {
+            uint64_t mod = moduli_[i];
+            IMATHLIB_ASSERT(mod > 1);
+            // partial_[i][j] = m[0] * ... * m[j - 1] mod m[i]
+            uint64_t product = 1;
+            for (size_t j = 0; j < i; ++j) {
+                partial_[i][j] = product;
+                product = mulmod(product, moduli_[j], mod);
+            }
+            inverses_[i] = modInverse(product, mod);
+            IMATHLIB_ASSERT(i == 0 || inverses_[i] != 0);
+        }
+    }
 
-struct FactorU64 {
-    uint64_t prime;
-    uint64_t power;
+    /**
+     * Garner's algorithm: x = d[0] + d[1] * m[0] + d[2] * m[0] * m[1] + ...
+     * with 0 <= d[i] < m[i]. Taking it modulo m[i] gives
+     * d[i] = (r[i] - (d[0] + d[1] * m[0] + ...)) / (m[0] * ... * m[i - 1])
+     * */
+    IMATHLIB_CONSTEXPR_X64
+    void mixedRadixDigits(const uint64_t* residues,
+                          uint64_t* digits) const noexcept {
+        for (size_t i = 0; i < SIZE; ++i) {
+            uint64_t mod = moduli_[i];
+            uint64_t sum = 0;
+            for (size_t j = 0; j < i; ++j) {
+                uint64_t term = mulmod(digits[j], partial_[i][j], mod);
+                sum += term;
+                // sum + term may overflow for mod > 2^63
+                sum -= (sum >= mod || sum < term) ? mod : 0;
+            }
+            uint64_t residue = residues[i] % mod;
+            uint64_t diff = residue >= sum ? residue - sum
+                                           : residue + (mod - sum);
+            digits[i] = mulmod(diff, inverses_[i], mod);
+        }
+    }
+
+    uint64_t moduli_[SIZE]{};
+    uint64_t inverses_[SIZE]{};
+    uint64_t partial_[SIZE][SIZE]{};
 };
 
 /**
- * Stores results of a 64-bit number factorization.
- * Results are in a form of pairs {prime, power}. Primes are in ascending order.
- * Multiplication of all pairs [i].prime ** [i].power will give the original
- * factored number.
+ * The largest prime p < upper_bound of the form k * 2^log_size + 1,
+ * so that NTT of size up to 2^log_size is possible modulo p.
+ * Returns 0 if there is no such prime.
  * */
-class FactorizationResultU64 {
+IMATHLIB_CONSTEXPR_INTR uint32_t nttPrime(uint32_t upper_bound,
+                                          uint32_t log_size) {
+    IMATHLIB_ASSERT(log_size < 32);
+    uint32_t step = uint32_t{1} << log_size;
+    if (upper_bound <= step + 1) return 0;
+    for (uint32_t k = (upper_bound - 2) / step; k > 0; --k) {
+        uint32_t p = k * step + 1;
+        if (isPrime(p)) return p;
+    }
+    return 0;
+}
+
+IMATHLIB_CONSTEXPR_X64 uint64_t nttPrime(uint64_t upper_bound,
+                                         uint32_t log_size) {
+    IMATHLIB_ASSERT(log_size < 64);
+    uint64_t step = uint64_t{1} << log_size;
+    if (upper_bound <= step + 1) return 0;
+    for (uint64_t k = (upper_bound - 2) / step; k > 0; --k) {
+        uint64_t p = k * step + 1;
+        if (isPrime(p)) return p;
+    }
+    return 0;
+}
+
+/**
+ * Number-theoretic transform modulo a prime p = k * 2^m + 1
+ * (see nttPrime), for sizes being powers of two up to 2^m.
+ * T is uint32_t with p < 2^31, or uint64_t with p < 2^63.
+ *
+ * The forward transform takes numbers in natural order and returns the
+ * transformed ones in bit-reversed order, the inverse transform does the
+ * opposite. It is all that convolutions need, and saves two permutations.
+ *
+ * Forward transform is the DFT with w = g^((p - 1) / size), where g is
+ * primitiveRoot(), found by factorization of p - 1.
+ *
+ * Butterflies use Montgomery multiplication by twiddle factors stored in
+ * Montgomery form, so the data itself stays in the normal form.
+ * Twiddles are stored in bit-reversed order, so that every block of
+ * every stage needs only one of them, tw[block index].
+ * Stages are fused in pairs (radix-4), and once blocks are small enough
+ * to fit in the cache, all the remaining stages are done block by block.
+ * With AVX2, 32-bit butterflies run in 8 lanes at once.
+ * */
+template <typename T>
+class Ntt {
 public:
-    constexpr size_t size() const noexcept {
-        return size_;
+    static_assert(std::is_same<T, uint32_t>::value ||
+                  std::is_same<T, uint64_t>::value,
+                  "Ntt is available only for uint32_t and uint64_t");
+
+    /**
+     * Prepares twiddle factors for transforms of size up to max_size,
+     * which must be a power of two dividing mod - 1.
+     * */
+    Ntt(T mod, size_t max_size) : mod_{mod}, max_size_{max_size} {
+        IMATHLIB_ASSERT(isPrime(mod));
+        IMATHLIB_ASSERT(mod >> (sizeof(T) * 8 - 1) == 0);
+        IMATHLIB_ASSERT(max_size >= 2);
+        IMATHLIB_ASSERT((max_size & (max_size - 1)) == 0);
+        IMATHLIB_ASSERT((mod - 1) % max_size == 0);
+
+        mod_inverse_ = detail::inverseModPow2(mod);
+        root_ = findPrimitiveRoot(mod);
+
+        // tw[j] = w^bitreverse(j), for w of order max_size
+        size_t half = max_size / 2;
+        T w = powmod(root_, static_cast<T>((mod - 1) / max_size), mod);
+        T w_inverse = modInverse(w, mod);
+        twiddles_.reset(new T[half]);
+        inverse_twiddles_.reset(new T[half]);
+        T power = 1;
+        T inverse_power = 1;
+        for (size_t j = 0; j < half; ++j) {
+            size_t reversed = bitReverse(j, half);
+            twiddles_[reversed] = detail::toMontgomery(power, mod);
+            inverse_twiddles_[reversed] =
+                detail::toMontgomery(inverse_power, mod);
+            power = mulmod(power, w, mod);
+            inverse_power = mulmod(inverse_power, w_inverse, mod);
+        }
     }
-    constexpr const FactorU64* begin() const noexcept {
-        return factors_;
+
+    T modulo() const noexcept {
+        return mod_;
     }
-    constexpr const FactorU64* end() const noexcept {
-        return factors_ + size_;
+    size_t maxSize() const noexcept {
+        return max_size_;
     }
-    constexpr const FactorU64& operator[](size_t idx) const {
-        return factors_[idx];
+    /**
+     * The primitive root modulo p, which generated the twiddle factors.
+     * */
+    T primitiveRoot() const noexcept {
+        return root_;
     }
-    constexpr const FactorU64& back() const {
-        return factors_[size_ - 1];
+
+    /**
+     * In-place forward transform of data[0..size), numbers must be < p.
+     * The result is in bit-reversed order.
+     * */
+    void forward(T* data, size_t size) const noexcept {
+        IMATHLIB_ASSERT(size <= max_size_);
+        IMATHLIB_ASSERT((size & (size - 1)) == 0);
+        size_t len = firstBlockedLen(size);
+        for (size_t l = size / 2; l > len; l /= 4) {
+            forwardRadix4(data, 0, size, l);
+        }
+        size_t block = 2 * len;
+        for (size_t start = 0; block > 1 && start < size; start += block) {
+            size_t l = len;
+            for (; l >= 2; l /= 4) {
+                forwardRadix4(data, start, start + block, l);
+            }
+            if (l == 1) {
+                forwardRadix2(data, start, start + block, l);
+            }
+        }
+    }
+
+    /**
+     * In-place inverse transform of data[0..size) in bit-reversed order,
+     * numbers must be < p. The result is in natural order.
+     * */
+    void inverse(T* data, size_t size) const noexcept {
+        inverseScaled(data, size,
+                      detail::toMontgomery(modInverse(static_cast<T>(size),
+                                                      mod_), mod_));
+    }
+
+    /**
+     * out[k] = sum of a[i] * b[k - i] modulo p, for k < a_size + b_size - 1.
+     * a_size + b_size - 1 must not exceed maxSize().
+     * */
+    void convolve(const T* a, size_t a_size, const T* b, size_t b_size,
+                  T* out) const {
+        if (a_size == 0 || b_size == 0) return;
+        size_t out_size = a_size + b_size - 1;
+        size_t size = 1;
+        while (size < out_size) size *= 2;
+        IMATHLIB_ASSERT(size <= max_size_);
+
+        std::unique_ptr<T[]> fa{new T[size]{}};
+        std::unique_ptr<T[]> fb{new T[size]{}};
+        for (size_t i = 0; i < a_size; ++i) fa[i] = a[i] % mod_;
+        for (size_t i = 0; i < b_size; ++i) fb[i] = b[i] % mod_;
+        forward(fa.get(), size);
+        forward(fb.get(), size);
+        // Montgomery product is a * b * R^-1, and the inverse transform
+        // multiplies by n^-1 * R^2 * R^-1 to fix it.
+        for (size_t i = 0; i < size; ++i) {
+            fa[i] = detail::montgomeryMul(fa[i], fb[i], mod_, mod_inverse_);
+        }
+        T scale = modInverse(static_cast<T>(size), mod_);
+        scale = detail::toMontgomery(detail::toMontgomery(scale, mod_), mod_);
+        inverseScaled(fa.get(), size, scale);
+        for (size_t i = 0; i < out_size; ++i) out[i] = fa[i];
+    }
+
+private:
+    // In number of elements, so that a block of 32-bit numbers fits in L1
+    static constexpr size_t kBlockSize = 4096;
+
+    T mod_;
+    T mod_inverse_{};
+    T root_{};
+    size_t max_size_;
+    std::unique_ptr<T[]> twiddles_;
+    std::unique_ptr<T[]> inverse_twiddles_;
+
+    static size_t bitReverse(size_t n, size_t size) noexcept {
+        size_t result = 0;
+        for (size_t bit = 1; bit < size; bit *= 2) {
+            result = (result << 1) | ((n & bit) ? 1 : 0);
+        }
+        return result;
+    }
+
+    /**
+     * g is a primitive root iff g^((p - 1) / q) != 1 for every prime q | p - 1
+     * */
+    static T findPrimitiveRoot(T mod) noexcept {
+        auto factors = factorize(static_cast<T>(mod - 1));
+        for (T g = 2;; ++g) {
+            bool is_root = true;
+            for (const auto& factor : factors) {
+                T q = static_cast<T>(factor.prime);
+                is_root &= powmod(g, static_cast<T>((mod - 1) / q), mod) != 1;
+            }
+            if (is_root) return g;
+        }
+    }
+
+    static T addMod(T a, T b, T mod) noexcept {
+        T sum = a + b;
+        return sum >= mod ? sum - mod : sum;
+    }
+    static T subMod(T a, T b, T mod) noexcept {
+        return a >= b ? a - b : a + (mod - b);
+    }
+
+    /**
+     * Forward stages with len > firstBlockedLen(size) go through all the
+     * data, radix-4 halves their number. Then blocks of 2 * len fit in the
+     * cache, and all the remaining stages are done block by block.
+     * */
+    static size_t firstBlockedLen(size_t size) noexcept {
+        size_t len = size / 2;
+        while (2 * len > kBlockSize) len /= 4;
+        return len;
     }
 
-private:
     /**
-     * Used to add prime factors found in incresing order using trialdivision
+     * Cooley-Tukey butterflies (u, v) -> (u + w * v, u - w * v) of a single
+     * stage, for the blocks of size 2 * len in data[begin..end).
      * */
-    constexpr void addFactor(FactorU64 f) {
-        factors_[size_++] = f;
+    void forwardRadix2(T* data, size_t begin, size_t end,
+                       size_t len) const noexcept {
+        // Local copies, as stores to data could alias the members
+        const T mod = mod_;
+        const T mod_inverse = mod_inverse_;
+        size_t block = begin / (2 * len);
+        for (size_t start = begin; start < end; start += 2 * len) {
+            T w = twiddles_[block++];
+            T* x = data + start;
+            T* y = x + len;
+            for (size_t i = 0; i < len; ++i) {
+                T u = x[i];
+                T v = detail::montgomeryMul(y[i], w, mod, mod_inverse);
+                x[i] = addMod(u, v, mod);
+                y[i] = subMod(u, v, mod);
+            }
+        }
     }
 
     /**
-     * Used to add prime factors found in not specified order.
-     * Performs a linear search to find if the prime factor already occured.
-     * Then either adds power to the existing factor, or performs insertion.
+     * Stages len and len / 2 fused, so that data is passed through once.
+     * Block j of the first stage uses tw[j], and its halves in the second
+     * stage are blocks 2j and 2j + 1, using tw[2j] and tw[2j + 1].
      * */
-    constexpr void addUnorderedFactor(FactorU64 f) {
-        size_t i = 0;
-        for (; i < size_ && factors_[i].prime < f.prime; ++i);
-        if (factors_[i].prime == f.prime) {
-            factors_[i].power += f.power;
-            return;
-        }
-        // if not found, perform an insertion
-        FactorU64 swapper = f;
-        for (; i < size_; ++i) {
-            detail::simpleSwap(swapper, factors_[i]);
+    void forwardRadix4(T* data, size_t begin, size_t end,
+                       size_t len) const noexcept {
+        const T mod = mod_;
+        const T mod_inverse = mod_inverse_;
+        size_t quarter = len / 2;
+        size_t block = begin / (2 * len);
+        for (size_t start = begin; start < end; start += 2 * len, ++block) {
+            T w1 = twiddles_[block];
+            T w2 = twiddles_[2 * block];
+            T w3 = twiddles_[2 * block + 1];
+            T* x0 = data + start;
+            T* x1 = x0 + quarter;
+            T* x2 = x1 + quarter;
+            T* x3 = x2 + quarter;
+            size_t i = 0;
+#if IMATHLIB_AVX2_KERNELS
+            if (detail::hasAvx2()) {
+                i = detail::forwardRadix4Avx2(x0, quarter, w1, w2, w3, mod,
+                                              mod_inverse);
+            }
+#endif
+            for (; i < quarter; ++i) {
+                T a0 = x0[i];
+                T a1 = x1[i];
+                T a2 = detail::montgomeryMul(x2[i], w1, mod, mod_inverse);
+                T a3 = detail::montgomeryMul(x3[i], w1, mod, mod_inverse);
+                T b0 = addMod(a0, a2, mod);
+                T b2 = subMod(a0, a2, mod);
+                T b1 = detail::montgomeryMul(addMod(a1, a3, mod), w2, mod,
+                                             mod_inverse);
+                T b3 = detail::montgomeryMul(subMod(a1, a3, mod), w3, mod,
+                                             mod_inverse);
+                x0[i] = addMod(b0, b1, mod);
+                x1[i] = subMod(b0, b1, mod);
+                x2[i] = addMod(b2, b3, mod);
+                x3[i] = subMod(b2, b3, mod);
+            }
         }
-        factors_[size_++] = swapper;
     }
 
-    FactorU64 factors_[16]{};
-    size_t size_{};
-    friend IMATHLIB_CONSTEXPR_X64
-    FactorizationResultU64 factorize(uint64_t n) noexcept;
-};
-
-IMATHLIB_CONSTEXPR_INTR FactorizationResultU32 factorize(uint32_t n) noexcept {
-    constexpr const size_t kSmallPrimesTested = 16;
-    static_assert(kSmallPrimesTested >= 4,
-                  "2, 3, 5, 7 are used in primality test, "
-		  "so we need to test them here too");
-    FactorizationResultU32 result{};
-
-    for (size_t i = 0; i < kSmallPrimesTested; ++i) {
-        uint32_t prime = kSmallPrimes[i];
-        if (n % prime == 0) {
-            FactorU32 f{};
-            f.prime = prime;
-            do {
-                n /= prime;
-                ++f.power;
-            } while (n % prime == 0);
-            result.addFactor(f);
+    /**
+     * Gentleman-Sande butterflies (x, y) -> (x + y, (x - y) * w^-1),
+     * reversing the forwardRadix2 up to the factor 2.
+     * */
+    void inverseRadix2(T* data, size_t begin, size_t end,
+                       size_t len) const noexcept {
+        const T mod = mod_;
+        const T mod_inverse = mod_inverse_;
+        size_t block = begin / (2 * len);
+        for (size_t start = begin; start < end; start += 2 * len) {
+            T w = inverse_twiddles_[block++];
+            T* x = data + start;
+            T* y = x + len;
+            for (size_t i = 0; i < len; ++i) {
+                T u = x[i];
+                T v = y[i];
+                x[i] = addMod(u, v, mod);
+                y[i] = detail::montgomeryMul(subMod(u, v, mod), w, mod,
+                                             mod_inverse);
+            }
         }
     }
 
-    if (n == 1 || isPrime(n)) {
-        result.addFactor({n, 1});
-        return result;
+    /**
+     * Stages len and 2 * len fused, reversing the forwardRadix4.
+     * */
+    void inverseRadix4(T* data, size_t begin, size_t end,
+                       size_t len) const noexcept {
+        const T mod = mod_;
+        const T mod_inverse = mod_inverse_;
+        size_t block = begin / (4 * len);
+        for (size_t start = begin; start < end; start += 4 * len, ++block) {
+            T w1 = inverse_twiddles_[block];
+            T w2 = inverse_twiddles_[2 * block];
+            T w3 = inverse_twiddles_[2 * block + 1];
+            T* x0 = data + start;
+            T* x1 = x0 + len;
+            T* x2 = x1 + len;
+            T* x3 = x2 + len;
+            size_t i = 0;
+#if IMATHLIB_AVX2_KERNELS
+            if (detail::hasAvx2()) {
+                i = detail::inverseRadix4Avx2(x0, len, w1, w2, w3, mod,
+                                              mod_inverse);
+            }
+#endif
+            for (; i < len; ++i) {
+                T a0 = x0[i];
+                T a1 = x1[i];
+                T a2 = x2[i];
+                T a3 = x3[i];
+                T b0 = addMod(a0, a1, mod);
+                T b1 = detail::montgomeryMul(subMod(a0, a1, mod), w2, mod,
+                                             mod_inverse);
+                T b2 = addMod(a2, a3, mod);
+                T b3 = detail::montgomeryMul(subMod(a2, a3, mod), w3, mod,
+                                             mod_inverse);
+                x0[i] = addMod(b0, b2, mod);
+                x1[i] = addMod(b1, b3, mod);
+                x2[i] = detail::montgomeryMul(subMod(b0, b2, mod), w1, mod,
+                                              mod_inverse);
+                x3[i] = detail::montgomeryMul(subMod(b1, b3, mod), w1, mod,
+                                              mod_inverse);
+            }
+        }
     }
 
-    // Pollard's Rho algorithm may return a composite divisor,
-    // so we need to keep track of all calculated composite divisors.
-    // We only add prime factors to the result
-    uint32_t composite_factors[8]{n, };
-    size_t composite_factors_count = 1;
-    uint32_t init_value = 0x12345678;  // arbitrary non-zero
-
-    while (composite_factors_count > 0) {
-        uint32_t cf = composite_factors[--composite_factors_count];
-        uint32_t f = 0;
+    /**
+     * Inverse transform, multiplied by scale * R^-1 at the end.
+     * */
+    void inverseScaled(T* data, size_t size, T scale) const noexcept {
+        IMATHLIB_ASSERT(size <= max_size_);
+        IMATHLIB_ASSERT((size & (size - 1)) == 0);
+        size_t block = 2 * firstBlockedLen(size);
+        // forward did a single radix-2 stage for odd log2(block)
+        bool odd_stages = false;
+        for (size_t len = 1; len < block; len *= 2) {
+            odd_stages = !odd_stages;
+        }
+        for (size_t start = 0; block > 1 && start < size; start += block) {
+            size_t len = 1;
+            if (odd_stages) {
+                inverseRadix2(data, start, start + block, len);
+                len *= 2;
+            }
+            for (; len < block; len *= 4) {
+                inverseRadix4(data, start, start + block, len);
+            }
+        }
+        for (size_t len = block; len > 0 && len < size; len *= 4) {
+            inverseRadix4(data, 0, size, len);
+        }
+        for (size_t i = 0; i < size; ++i) {
+            data[i] = detail::montgomeryMul(data[i], scale, mod_,
+                                            mod_inverse_);
+        }
+    }
 
-        // Pollard's Rho algorithm might fail to find a divisor,
-        // so retry with different initial values
-        do {
-            f = detail::pollardRhoFactorization(cf, init_value);
-            // xor-shift, to get another random init_value
-            // https://en.wikipedia.org/wiki/Xorshift
-            init_value ^= init_value << 13;
-            init_value ^= init_value >> 17;
-            init_value ^= init_value << 5;
-        } while (f == cf);
+};
 
-        if (isPrime(f)) {
-            result.addUnorderedFactor({f, 1});
-        } else {
-            composite_factors[composite_factors_count++] = f;
+/**
+ * Division by a runtime-invariant divisor d > 0, as in libdivide.
+ * n / d = mulhi(n, magic) >> shift, where mulhi is the high half of
+ * the product, and magic is precomputed once for the divisor.
+ *
+ * For some divisors the magic number needs one bit more than T has,
+ * then the lowest bits of it are stored, and the missing n is added back:
+ * with q = mulhi(n, magic), n / d = (((n - q) >> 1) + q) >> shift.
+ * Powers of two are a plain shift.
+ *
+ * The default variant picks one of the three sequences with branches on
+ * the divisor, which are perfectly predictable in a loop.
+ * With BRANCHFREE all divisors go through the longest sequence,
+ * which is better if the divisor changes between the calls.
+ * */
+template <typename T, bool BRANCHFREE>
+class Divider {
+public:
+    static_assert(std::is_same<T, uint32_t>::value ||
+                  std::is_same<T, uint64_t>::value,
+                  "Divider is available only for uint32_t and uint64_t");
+
+    IMATHLIB_CONSTEXPR_X64 explicit Divider(T d) noexcept : divisor_{d} {
+        IMATHLIB_ASSERT(d > 0);
+        int log2_d = static_cast<int>(sizeof(T) * 8 - 1) - detail::clz(d);
+        if ((d & (d - 1)) == 0) {
+            // n >> log2_d, with magic == 0 the branchfree sequence
+            // gives (n >> pre_shift_) >> shift_
+            pre_shift_ = (BRANCHFREE && d > 1) ? 1 : 0;
+            shift_ = log2_d - pre_shift_;
+            return;
         }
 
-        cf /= f;
+        // floor(2^(bits + log2_d) / d), and the remainder
+        T high = T{1} << log2_d;
+        T proposed = detail::wideQuotient(high, d);
+        T remainder = static_cast<T>(0 - proposed * d);
+        shift_ = log2_d;
+        if (!BRANCHFREE && d - remainder < high) {
+            // magic = ceil(2^(bits + log2_d) / d) fits in T
+            magic_ = proposed + 1;
+            return;
+        }
 
-        if (isPrime(cf)) {
-            result.addUnorderedFactor({cf, 1});
-        } else {
-            composite_factors[composite_factors_count++] = cf;
+        // magic = ceil(2^(bits + log2_d + 1) / d) - 2^bits
+        proposed += proposed;
+        T twice_remainder = remainder + remainder;
+        if (twice_remainder >= d || twice_remainder < remainder) {
+            proposed += 1;
         }
+        magic_ = proposed + 1;
+        pre_shift_ = 1;
     }
 
-    return result;
-}
-
-IMATHLIB_CONSTEXPR_X64 FactorizationResultU64 factorize(uint64_t n) noexcept {
-    constexpr const size_t kSmallPrimesTested = 16;
-    static_assert(kSmallPrimesTested >= 4,
-                  "2, 3, 5, 7 are used in primality test, so we need to test them here too");
-    FactorizationResultU64 result{};
-    if (n <= 1) return result;
+    constexpr T divisor() const noexcept {
+        return divisor_;
+    }
 
-    for (size_t i = 0; i < kSmallPrimesTested; ++i) {
-        uint32_t prime = kSmallPrimes[i];
-        if (n % prime == 0) {
-            FactorU64 f{};
-            f.prime = prime;
-            do {
-                n /= prime;
-                ++f.power;
-            } while (n % prime == 0);
-            result.addFactor(f);
+    IMATHLIB_CONSTEXPR_X64 T divide(T n) const noexcept {
+        if (BRANCHFREE) {
+            T q = detail::mulHigh(n, magic_);
+            return (((n - q) >> pre_shift_) + q) >> shift_;
         }
+        if (magic_ == 0) {
+            return n >> shift_;
+        }
+        T q = detail::mulHigh(n, magic_);
+        if (pre_shift_ != 0) {
+            q = ((n - q) >> 1) + q;
+        }
+        return q >> shift_;
     }
 
-    if (n == 1 || isPrime(n)) {
-        result.addFactor({n, 1});
-        return result;
+    IMATHLIB_CONSTEXPR_X64 T mod(T n) const noexcept {
+        return n - divide(n) * divisor_;
     }
 
-    // Pollard's Rho algorithm may return a composite divisor,
-    // so we need to keep track of all calculated composite divisors.
-    // We only add prime factors to the result
-    uint64_t composite_factors[8]{n, };
-    size_t composite_factors_count = 1;
-    uint64_t init_value = 0x1234567890abcdefull;  // arbitrary non-zero
+    IMATHLIB_CONSTEXPR_X64 bool isDivisible(T n) const noexcept {
+        return mod(n) == 0;
+    }
 
-    while (composite_factors_count > 0) {
-        uint64_t cf = composite_factors[--composite_factors_count];
-        uint64_t f = 0;
+    /**
+     * The smallest multiple of d not less than n, it must fit in T.
+     * */
+    IMATHLIB_CONSTEXPR_X64 T roundUp(T n) const noexcept {
+        IMATHLIB_ASSERT((n + divisor_ - 1) >= n);
+        return divide(n + divisor_ - 1) * divisor_;
+    }
 
-        // Pollard's Rho algorithm might fail to find a divisor,
-        // so retry with different initial values
-        do {
-            f = detail::pollardRhoFactorization(cf, init_value);
-            // xor-shift, to get another random init_value
-            // https://en.wikipedia.org/wiki/Xorshift
-            init_value ^= init_value >> 12;
-            init_value ^= init_value << 25;
-            init_value ^= init_value >> 27;
-        } while (f == cf);
+    /**
+     * The largest multiple of d not greater than n.
+     * */
+    IMATHLIB_CONSTEXPR_X64 T roundDown(T n) const noexcept {
+        return divide(n) * divisor_;
+    }
 
-        if (isPrime(f)) {
-            result.addUnorderedFactor({f, 1});
-        } else {
-            composite_factors[composite_factors_count++] = f;
-        }
+private:
+    T divisor_ = 0;
+    T magic_ = 0;
+    int pre_shift_ = 0;
+    int shift_ = 0;
+};
 
-        cf /= f;
+constexpr uint32_t roundUpToMultipleOf(uint32_t n, uint32_t mul) {
+    IMATHLIB_ASSERT(mul);
+    IMATHLIB_ASSERT((n + mul - 1) >= n);
+    return ((n + mul - 1) / mul) * mul;
+}
 
-        if (isPrime(cf)) {
-            result.addUnorderedFactor({cf, 1});
-        } else {
-            composite_factors[composite_factors_count++] = cf;
-        }
-    }
+constexpr uint64_t roundUpToMultipleOf(uint64_t n, uint64_t mul) {
+    IMATHLIB_ASSERT(mul);
+    IMATHLIB_ASSERT((n + mul - 1) >= n);
+    return ((n + mul - 1) / mul) * mul;
+}
 
-    return result;
+template <typename T, bool BRANCHFREE>
+IMATHLIB_CONSTEXPR_X64 T roundUpToMultipleOf(
+    T n, const Divider<T, BRANCHFREE>& mul) {
+    return mul.roundUp(n);
 }
 
-constexpr uint32_t pow(uint32_t n, uint32_t pow) noexcept {
-    uint32_t result = 1;
-    while (pow) {
-        if (pow & 1) result *= n;
-        n *= n;
-        pow >>= 1;
-    }
-    return result;
+constexpr uint32_t roundDownToMultipleOf(uint32_t n, uint32_t mul) {
+    IMATHLIB_ASSERT(mul);
+    return n - n % mul;
 }
-constexpr uint64_t pow(uint64_t n, uint64_t pow) noexcept {
-    uint64_t result = 1;
-    while (pow) {
-        if (pow & 1) result *= n;
-        n *= n;
-        pow >>= 1;
-    }
-    return result;
+
+constexpr uint64_t roundDownToMultipleOf(uint64_t n, uint64_t mul) {
+    IMATHLIB_ASSERT(mul);
+    return n - n % mul;
 }
 
-constexpr uint32_t mulmod(uint32_t a, uint32_t b, uint32_t mod) {
-    IMATHLIB_ASSERT(mod > 0);
-    return static_cast<uint32_t>((uint64_t{a} * b) % mod);
+template <typename T, bool BRANCHFREE>
+IMATHLIB_CONSTEXPR_X64 T roundDownToMultipleOf(
+    T n, const Divider<T, BRANCHFREE>& mul) {
+    return mul.roundDown(n);
 }
-IMATHLIB_CONSTEXPR_X64
-uint64_t mulmod(uint64_t a, uint64_t b, uint64_t mod) {
-    IMATHLIB_ASSERT(mod > 0);
-    if ((mod & (mod - 1)) == 0) {  // is power of two
-        return (a * b) & (mod - 1);
-    }
 
-    detail::u128 x = detail::mul64x64(a, b);
-    if (x.hi >= mod) {
-        x.hi %= mod;
-    }
-    if (x.hi == 0) {
-        return x.lo % mod;
-    }
+// Floating point roots are much faster than Newton's method,
+// but they are not constexpr, so they are used only if we can tell
+// that the function is not constant evaluated.
+#if IMATHLIB_HAS_CONSTEXPR_INTR && !IMATHLIB_HAS_CONSTEXPR20 && \
+    !IMATHLIB_HAS_BUILTIN_CONSTEVAL || IMATHLIB_FORCE_FALLBACK
+#define IMATHLIB_FLOAT_ROOTS 0
+#else
+#define IMATHLIB_FLOAT_ROOTS 1
+#endif
 
-    return detail::mod128by64(x, mod);
+IMATHLIB_CONSTEXPR_INTR uint32_t isqrt(uint32_t n) noexcept {
+    return static_cast<uint32_t>(isqrt(uint64_t{n}));
 }
 
-constexpr uint32_t powmod(uint32_t n, uint32_t pow, uint32_t mod) {
-    IMATHLIB_ASSERT(mod > 0);
-    uint32_t cur = n;
-    uint32_t res = 1;
-    while (pow) {
-        if (pow & 1) res = mulmod(cur, res, mod);
-        cur = mulmod(cur, cur, mod);
-        pow >>= 1;
+IMATHLIB_CONSTEXPR_INTR uint64_t isqrt(uint64_t n) noexcept {
+#if IMATHLIB_FLOAT_ROOTS
+    if (!IMATHLIB_IS_CONSTEVAL) {
+        return detail::isqrtFloat(n);
     }
-    return res;
+#endif
+    return detail::isqrtNewton(n);
 }
-IMATHLIB_CONSTEXPR_X64
-uint64_t powmod(uint64_t n, uint64_t pow, uint64_t mod) {
-    IMATHLIB_ASSERT(mod > 0);
-    uint64_t cur = n;
-    uint64_t res = 1;
-    while (pow) {
-        if (pow & 1) res = mulmod(cur, res, mod);
-        cur = mulmod(cur, cur, mod);
-        pow >>= 1;
-    }
-    return res;
+
+IMATHLIB_CONSTEXPR_INTR uint32_t icbrt(uint32_t n) noexcept {
+    return static_cast<uint32_t>(icbrt(uint64_t{n}));
 }
 
-IMATHLIB_CONSTEXPR_INTR uint32_t gcd(uint32_t a, uint32_t b) noexcept {
-    if (IMATHLIB_IS_CONSTEVAL) {
-        return detail::gcdModuloRecursive(a, b);
+IMATHLIB_CONSTEXPR_INTR uint64_t icbrt(uint64_t n) noexcept {
+#if IMATHLIB_FLOAT_ROOTS
+    if (!IMATHLIB_IS_CONSTEVAL) {
+        return detail::icbrtFloat(n);
     }
-
-#if defined(IMATHLIB_FAST_CTZ32)
-    return detail::gcdBinary(a, b);
-#else
-    return detail::gcdModuloRecursive(a, b);
 #endif
+    return detail::irootNewton(n, 3);
 }
 
-IMATHLIB_CONSTEXPR_INTR uint64_t gcd(uint64_t a, uint64_t b) noexcept {
-    if (IMATHLIB_IS_CONSTEVAL) {
-        return detail::gcdModuloRecursive(a, b);
-    }
+IMATHLIB_CONSTEXPR_INTR uint32_t iroot(uint32_t n, uint32_t k) {
+    return static_cast<uint32_t>(iroot(uint64_t{n}, k));
+}
 
-#if defined(IMATHLIB_FAST_CTZ64)
-    return detail::gcdBinary(a, b);
-#else
-    return detail::gcdModuloRecursive(a, b);
-#endif
+IMATHLIB_CONSTEXPR_INTR uint64_t iroot(uint64_t n, uint32_t k) {
+    IMATHLIB_ASSERT(k > 0);
+    if (k == 1) return n;
+    if (k == 2) return isqrt(n);
+    if (k == 3) return icbrt(n);
+    return detail::irootNewton(n, k);
 }
 
-IMATHLIB_CONSTEXPR_INTR uint32_t lcm(uint32_t a, uint32_t b) noexcept {
-    return a / gcd (a, b) * b;
+/**
+ * floor(log2(n)), the index of the highest set bit. ilog2(0) is 0.
+ * */
+IMATHLIB_CONSTEXPR_INTR uint32_t ilog2(uint32_t n) noexcept {
+    return static_cast<uint32_t>(31 - detail::clz(n | 1));
 }
 
-IMATHLIB_CONSTEXPR_INTR uint64_t lcm(uint64_t a, uint64_t b) noexcept {
-    return a / gcd (a, b) * b;
+IMATHLIB_CONSTEXPR_INTR uint32_t ilog2(uint64_t n) noexcept {
+    return static_cast<uint32_t>(63 - detail::clz(n | 1));
 }
 
-constexpr uint32_t roundUpToMultipleOf(uint32_t n, uint32_t mul) {
-    IMATHLIB_ASSERT(mul);
-    IMATHLIB_ASSERT((n + mul - 1) > n);
-    return ((n + mul - 1) / mul) * mul;
+/**
+ * floor(log10(n)), so a number has ilog10(n) + 1 digits. ilog10(0) is 0.
+ * There are no branches, 1233 / 4096 is slightly above log10(2), so
+ * the number of bits gives either the exact result, or the one too big by 1,
+ * and a comparison with the power of 10 from a table tells which one.
+ * */
+IMATHLIB_CONSTEXPR_INTR uint32_t ilog10(uint32_t n) noexcept {
+    return ilog10(uint64_t{n});
 }
 
-constexpr uint64_t roundUpToMultipleOf(uint64_t n, uint64_t mul) {
-    IMATHLIB_ASSERT(mul);
-    IMATHLIB_ASSERT((n + mul - 1) > n);
-    return ((n + mul - 1) / mul) * mul;
+IMATHLIB_CONSTEXPR_INTR uint32_t ilog10(uint64_t n) noexcept {
+    uint32_t guess = (ilog2(n) + 1) * 1233 >> 12;
+    return guess - ((n | 1) < detail::kPowersOf10[guess]);
 }
 
-constexpr uint32_t roundDownToMultipleOf(uint32_t n, uint32_t mul) {
-    IMATHLIB_ASSERT(mul);
-    return n - n % mul;
+/**
+ * floor(log_base(n)) for n > 0 and base >= 2.
+ * Starts from the lower bound given by the bit lengths,
+ * so only a few multiplications by base are needed.
+ * */
+IMATHLIB_CONSTEXPR_INTR uint32_t ilog(uint32_t n, uint32_t base) {
+    return ilog(uint64_t{n}, uint64_t{base});
 }
 
-constexpr uint64_t roundDownToMultipleOf(uint64_t n, uint64_t mul) {
-    IMATHLIB_ASSERT(mul);
-    return n - n % mul;
+IMATHLIB_CONSTEXPR_INTR uint32_t ilog(uint64_t n, uint64_t base) {
+    IMATHLIB_ASSERT(n > 0);
+    IMATHLIB_ASSERT(base >= 2);
+    if ((base & (base - 1)) == 0) {
+        return ilog2(n) / ilog2(base);
+    }
+    // base < 2^(ilog2(base) + 1), so base^result <= 2^ilog2(n) <= n
+    uint32_t result = ilog2(n) / (ilog2(base) + 1);
+    uint64_t power = pow(base, uint64_t{result});
+    while (power <= n / base) {
+        power *= base;
+        ++result;
+    }
+    return result;
 }
 
-IMATHLIB_CONSTEXPR20 bool isPerfectSquare(uint32_t n) noexcept {
+IMATHLIB_CONSTEXPR_INTR bool isPerfectSquare(uint32_t n) noexcept {
     // top 5 bits must be one of the following:
     // {0, 1, 4, 9, 16, 17, 25}
     // corresponding bits are lit down
@@ -1292,15 +4951,8 @@ IMATHLIB_CONSTEXPR20 bool isPerfectSquare(uint32_t n) noexcept {
     if (trailing_zeroes & 1) return false;
     n >>= trailing_zeroes;
     if ((n&7) != 1) return false;
-    uint32_t root{};
-    if (IMATHLIB_IS_CONSTEVAL) {
-        // it's slower than floating point sqrt (usually),
-        // so use it only for constexpr
-        root = detail::isqrt(n);
-    } else {
-        root = static_cast<uint32_t>(
-                std::roundf(std::sqrt(static_cast<float>(n))));
-    }
+    if (!detail::isSquareModSmallOdd(n)) return false;
+    uint32_t root = isqrt(n);
     return root * root == n;
 }
 
@@ -1310,7 +4962,7 @@ IMATHLIB_CONSTEXPR20 bool isPerfectSquare(uint32_t n) noexcept {
 // If you need performance, try replacing mask test with the
 // one from the function above, or with a lookup array.
 // If trailing zeroes test can't be performed quickly, consider omitting it.
-IMATHLIB_CONSTEXPR20 bool isPerfectSquare(uint64_t n) noexcept {
+IMATHLIB_CONSTEXPR_INTR bool isPerfectSquare(uint64_t n) noexcept {
     // top 6 bits must be one of the following:
     // {0, 1, 4, 9, 16, 17, 25, 33, 36, 41, 49, 57}
     // corresponding bits are lit down
@@ -1323,17 +4975,122 @@ IMATHLIB_CONSTEXPR20 bool isPerfectSquare(uint64_t n) noexcept {
     if (trailing_zeroes & 1) return false;
     n >>= trailing_zeroes;
     if ((n&7) != 1) return false;
-    uint64_t root{};
-    if (IMATHLIB_IS_CONSTEVAL) {
-        // it's slower than floating point sqrt (usually),
-        // so use it only for constexpr
-        root = detail::isqrt(n);
-    } else {
-        root = static_cast<uint64_t>(std::round(std::sqrt(n)));
-    }
+    if (!detail::isSquareModSmallOdd(n)) return false;
+    uint64_t root = isqrt(n);
     return root * root == n;
 }
 
+/**
+ * Tests all the numbers in a batch, results[i] = isPerfectSquare(numbers[i]).
+ * If the CPU has AVX2, the residue filters are applied to the whole array
+ * first, 4 numbers at once. Then the square root is calculated only for
+ * the few numbers that passed them. Without AVX2 the filters are not worth
+ * calculating for every number, so each one is tested separately.
+ * */
+inline void isPerfectSquare(const uint64_t* numbers, size_t count,
+                            bool* results) noexcept {
+    size_t vectorized = 0;
+#if IMATHLIB_AVX2_KERNELS
+    if (detail::hasAvx2()) {
+        vectorized = detail::isSquareResidueAvx2(numbers, count, results);
+    }
+    for (size_t i = 0; i < vectorized; ++i) {
+        if (results[i]) {
+            uint64_t root = isqrt(numbers[i]);
+            results[i] = root * root == numbers[i];
+        }
+    }
+#endif
+    for (size_t i = vectorized; i < count; ++i) {
+        results[i] = isPerfectSquare(numbers[i]);
+    }
+}
+
+IMATHLIB_CONSTEXPR_INTR PerfectPowerU32 isPerfectPower(uint32_t n) noexcept {
+    PerfectPowerU64 result = isPerfectPower(uint64_t{n});
+    return {static_cast<uint32_t>(result.root), result.exponent};
+}
+
+/**
+ * Tries prime exponents p in increasing order, taking p-th roots as long
+ * as they are exact. A p-th power of a root is also a p-th power, so
+ * once p fails, it is never needed again. Before a root is calculated,
+ * n must pass the residue filters, and p must divide the exponent of 2.
+ *
+ * Exponents above 13 are not tried one by one. Their roots are at most 13,
+ * as 14^17 > 2^64, so instead the few possible roots are checked.
+ * */
+IMATHLIB_CONSTEXPR_INTR PerfectPowerU64 isPerfectPower(uint64_t n) noexcept {
+    PerfectPowerU64 result{n, 1};
+    if (n < 4) return result;
+    uint32_t trailing_zeroes = static_cast<uint32_t>(detail::ctz(n));
+    for (size_t i = 0; kSmallPrimes[i] <= 13; ++i) {
+        uint32_t p = kSmallPrimes[i];
+        // root^p >= 2^p, so larger exponents are impossible too
+        if (ilog2(result.root) < p) return result;
+        while (trailing_zeroes % p == 0 && ilog2(result.root) >= p &&
+               detail::isPowerResidue(result.root, p)) {
+            uint64_t root = 0;
+            if (p == 2) {
+                root = isqrt(result.root);
+            } else {
+#if IMATHLIB_FLOAT_ROOTS
+                root = IMATHLIB_IS_CONSTEVAL
+                           ? iroot(result.root, p)
+                           : detail::irootNearestFloat(result.root, p);
+#else
+                root = iroot(result.root, p);
+#endif
+            }
+            if (detail::powSaturated(root, p) != result.root) break;
+            result.root = root;
+            result.exponent *= p;
+            trailing_zeroes /= p;
+        }
+    }
+
+    if (ilog2(result.root) < 17) return result;
+    // The root of such a power is not a perfect power itself,
+    // or a smaller exponent would be found above,
+    // so it is one of 2, 3, 5, 6, 7, 10, 11, 12, 13.
+    uint64_t root = result.root;
+    if (trailing_zeroes != 0) {
+        // root = (2^e * m)^(t / e), where m is 1, 3 or 5
+        uint64_t odd = root >> trailing_zeroes;
+        uint32_t t = trailing_zeroes;
+        if (odd == 1) {
+            result.root = 2;
+            result.exponent *= t;
+        } else if (odd == detail::powSaturated(3, t)) {
+            result.root = 6;
+            result.exponent *= t;
+        } else if (odd == detail::powSaturated(5, t)) {
+            result.root = 10;
+            result.exponent *= t;
+        } else if (t % 2 == 0 && odd == detail::powSaturated(3, t / 2)) {
+            result.root = 12;
+            result.exponent *= t / 2;
+        }
+        return result;
+    }
+
+    // Odd roots are primes, and only one of them can divide n
+    uint32_t residue = static_cast<uint32_t>(root % (3 * 5 * 7 * 11 * 13));
+    uint64_t prime = residue % 3 == 0    ? 3
+                     : residue % 5 == 0  ? 5
+                     : residue % 7 == 0  ? 7
+                     : residue % 11 == 0 ? 11
+                     : residue % 13 == 0 ? 13
+                                         : 0;
+    if (prime == 0) return result;
+    uint32_t exponent = ilog(root, prime);
+    if (pow(prime, uint64_t{exponent}) == root) {
+        result.root = prime;
+        result.exponent *= exponent;
+    }
+    return result;
+}
+
 }  // namespace imath
 
 // These are all the macros that can be defined by this header:
@@ -1344,12 +5101,30 @@ IMATHLIB_CONSTEXPR20 bool isPerfectSquare(uint64_t n) noexcept {
 // IMATHLIB_HAS_CONSTEXPR_INTR
 // IMATHLIB_HAS_CONSTEXPR_X64
 // IMATHLIB_HAS_CONSTEXPR20
+// IMATHLIB_HAS_BUILTIN_CONSTEVAL
 // IMATHLIB_IS_CONSTEVAL
 // IMATHLIB_ASSERT
 // IMATHLIB_ASSUME
+// IMATHLIB_FLOAT_ROOTS
+// IMATHLIB_FORCE_FALLBACK
+// IMATHLIB_HAS_INT128
+// IMATHLIB_HAS_EXCEPTIONS
+// IMATHLIB_ENABLE_THREADS
+// IMATHLIB_KNOWN_CONSTANT
+// IMATHLIB_STATS
+// IMATHLIB_STATS_ADD
+// IMATHLIB_STATS_MAX
+// IMATHLIB_STATS_TIMER
+// IMATHLIB_STATS_ELAPSED
+// IMATHLIB_AVX2
+// IMATHLIB_ENABLE_AVX2_DISPATCH
+// IMATHLIB_HAS_CPUID
+// IMATHLIB_AVX2_DISPATCH
+// IMATHLIB_AVX2_KERNELS
+// IMATHLIB_TARGET_AVX2
 // IMATHLIB_FAST_CLZ32
 // IMATHLIB_FAST_CLZ64
-// IMATHLIB_FAST_CTZ64
+// IMATHLIB_FAST_CTZ32
 // IMATHLIB_FAST_CTZ64
 
 #endif  // IMATHLIB_IMATH_H
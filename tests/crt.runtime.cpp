@@ -0,0 +1,85 @@
+#include "imath.h"
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using u64 = uint64_t;
+
+TEST_CASE( "CRT basis of consecutive primes", "[crt]" ) {
+    auto basis = imath::CrtBasis<3>::primesAfter(1000);
+    CHECK(basis.size() == 3);
+    CHECK(basis[0] == 1009);
+    CHECK(basis[1] == 1013);
+    CHECK(basis[2] == 1019);
+
+    const u64 residues[] = {1234567 % 1009, 1234567 % 1013, 1234567 % 1019};
+    CHECK(basis.reconstruct(residues) == 1234567);
+    const u64 not_reduced[] = {1234567, 1234567, 1234567};
+    CHECK(basis.reconstruct(not_reduced) == 1234567);
+    const u64 zeroes[] = {0, 0, 0};
+    CHECK(basis.reconstruct(zeroes) == 0);
+}
+
+TEST_CASE( "CRT reconstruction randomized", "[crt]" ) {
+    std::mt19937_64 rng{};
+    // Not primes, but pairwise coprime
+    const u64 moduli[] = {1ull << 40, 3486784401u /* 3^20 */,
+                          18446744073709551557u};
+    imath::CrtBasis<3> basis{moduli};
+    for (int test_case = 0; test_case < 100000; ++test_case) {
+        u64 x = rng() >> (rng() % 64);
+        u64 residues[3];
+        for (size_t i = 0; i < 3; ++i) residues[i] = x % moduli[i];
+        INFO("x = " << x);
+        CHECK(basis.reconstruct(residues) == x);
+        auto x128 = basis.reconstructU128(residues);
+        CHECK(x128.hi == 0);
+        CHECK(x128.lo == x);
+    }
+}
+
+TEST_CASE( "CRT reconstruction to 128 bits", "[crt]" ) {
+    std::mt19937_64 rng{};
+    // Product of the moduli is over 2^128
+    auto basis = imath::CrtBasis<3>::primesAfter(1ull << 43);
+    for (int test_case = 0; test_case < 100000; ++test_case) {
+        imath::detail::u128 x{rng() >> (rng() % 64), rng()};
+        u64 residues[3];
+        for (size_t i = 0; i < 3; ++i) {
+            u64 hi = x.hi % basis[i];
+            residues[i] = hi == 0 ? x.lo % basis[i] :
+                imath::detail::mod128by64({hi, x.lo}, basis[i]);
+        }
+        INFO("x = " << x.hi << " * 2^64 + " << x.lo);
+        auto result = basis.reconstructU128(residues);
+        CHECK(result.hi == x.hi);
+        CHECK(result.lo == x.lo);
+        CHECK(basis.reconstruct(residues) == x.lo);
+    }
+}
+
+TEST_CASE( "CRT batched reconstruction", "[crt]" ) {
+    std::mt19937_64 rng{};
+    auto basis = imath::CrtBasis<4>::primesAfter(1u << 20);
+    const size_t count = 1001;
+    std::vector<u64> numbers(count);
+    std::vector<u64> residues(count * 4);
+    for (size_t k = 0; k < count; ++k) {
+        numbers[k] = rng() >> 8;
+        for (size_t i = 0; i < 4; ++i) {
+            residues[k * 4 + i] = numbers[k] % basis[i];
+        }
+    }
+    std::vector<u64> out(count);
+    basis.reconstruct(residues.data(), count, out.data());
+    CHECK(out == numbers);
+
+    std::vector<imath::CrtU128> out128(count);
+    basis.reconstructU128(residues.data(), count, out128.data());
+    for (size_t k = 0; k < count; ++k) {
+        CHECK(out128[k].hi == 0);
+        CHECK(out128[k].lo == numbers[k]);
+    }
+}
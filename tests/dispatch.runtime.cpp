@@ -0,0 +1,57 @@
+#include "imath.h"
+#include "catch2/catch_test_macros.hpp"
+
+#include <random>
+#include <vector>
+
+TEST_CASE( "CPU features match the compiler's detection", "[dispatch]" ) {
+    imath::detail::CpuFeatures features = imath::detail::detectCpuFeatures();
+    imath::detail::CpuFeatures at_startup =
+        imath::detail::CpuDispatch<>::features;
+    CHECK(features.lzcnt == at_startup.lzcnt);
+    CHECK(features.bmi1 == at_startup.bmi1);
+    CHECK(features.bmi2 == at_startup.bmi2);
+    CHECK(features.avx2 == at_startup.avx2);
+#if IMATHLIB_HAS_CPUID && defined(__GNUC__)
+    CHECK(features.avx2 == (__builtin_cpu_supports("avx2") != 0));
+    CHECK(features.bmi1 == (__builtin_cpu_supports("bmi") != 0));
+    CHECK(features.bmi2 == (__builtin_cpu_supports("bmi2") != 0));
+#endif
+#if IMATHLIB_AVX2
+    CHECK(imath::detail::hasAvx2());
+#else
+    // The kernels are built for LZCNT, BMI1 and BMI2 too
+    CHECK(imath::detail::hasAvx2() == (features.avx2 && features.bmi1 &&
+                                       features.bmi2 && features.lzcnt));
+#endif
+}
+
+TEST_CASE( "Dispatched batch kernels match the scalar ones", "[dispatch]" ) {
+    std::mt19937_64 rng(2021);
+    std::vector<uint64_t> a(1003);
+    std::vector<uint64_t> b(a.size());
+    std::vector<uint64_t> squares(a.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        uint64_t common = rng() % 1000 + 1;
+        a[i] = (rng() >> 24) * common;
+        b[i] = (rng() >> 24) * common;
+        uint64_t root = rng() >> 32;
+        squares[i] = root * root + (i % 3 == 0 ? 0 : rng() % 3);
+    }
+    a[0] = 0;
+    b[1] = 0;
+
+    std::vector<uint64_t> out(a.size());
+    imath::gcd(a.data(), b.data(), a.size(), out.data());
+    for (size_t i = 0; i < a.size(); ++i) {
+        INFO("gcd(" << a[i] << ", " << b[i] << ")");
+        CHECK(out[i] == imath::gcd(a[i], b[i]));
+    }
+
+    std::unique_ptr<bool[]> results(new bool[squares.size()]);
+    imath::isPerfectSquare(squares.data(), squares.size(), results.get());
+    for (size_t i = 0; i < squares.size(); ++i) {
+        INFO("n = " << squares[i]);
+        CHECK(results[i] == imath::isPerfectSquare(squares[i]));
+    }
+}
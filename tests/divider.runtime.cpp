@@ -0,0 +1,83 @@
+#include "imath.h"
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstdint>
+#include <random>
+
+using u32 = uint32_t;
+using u64 = uint64_t;
+
+namespace {
+
+template <typename T, bool BRANCHFREE>
+void checkDivider(T d, T n) {
+    imath::Divider<T, BRANCHFREE> divider{d};
+    INFO("d = " << d << ", n = " << n << ", branchfree = " << BRANCHFREE);
+    CHECK(divider.divisor() == d);
+    CHECK(divider.divide(n) == n / d);
+    CHECK(divider.mod(n) == n % d);
+    CHECK(divider.isDivisible(n) == (n % d == 0));
+    CHECK(divider.roundDown(n) == n - n % d);
+    CHECK(imath::roundDownToMultipleOf(n, divider) ==
+          imath::roundDownToMultipleOf(n, d));
+    if (n <= static_cast<T>(static_cast<T>(-1) - d + 1)) {
+        CHECK(imath::roundUpToMultipleOf(n, divider) ==
+              (n % d == 0 ? n : n - n % d + d));
+    }
+}
+
+template <typename T>
+void checkBoth(T d, T n) {
+    checkDivider<T, false>(d, n);
+    checkDivider<T, true>(d, n);
+}
+
+}  // namespace
+
+TEST_CASE( "Divider edge cases", "[Divider]" ) {
+    const u64 numbers[] = {0, 1, 2, 3, 6, 7, 8, 641, 6700417,
+                           UINT32_MAX - 1, UINT32_MAX, u64{UINT32_MAX} + 1,
+                           UINT64_MAX / 3, UINT64_MAX - 1, UINT64_MAX};
+    for (u64 d : numbers) {
+        if (d == 0) continue;
+        for (u64 n : numbers) {
+            checkBoth<u64>(d, n);
+            checkBoth<u32>(static_cast<u32>(d) | 1, static_cast<u32>(n));
+        }
+    }
+}
+
+TEST_CASE( "Divider small divisors", "[Divider]" ) {
+    std::mt19937_64 rng{};
+    for (u64 d = 1; d < 1000; ++d) {
+        for (int test_case = 0; test_case < 100; ++test_case) {
+            u64 n = rng() >> (rng() % 64);
+            checkBoth<u64>(d, n);
+            checkBoth<u32>(static_cast<u32>(d), static_cast<u32>(n));
+        }
+    }
+}
+
+TEST_CASE( "Divider randomized", "[Divider]" ) {
+    std::mt19937_64 rng{};
+    for (int test_case = 0; test_case < 100000; ++test_case) {
+        u64 d = (rng() >> (rng() % 64)) | 1;
+        d <<= rng() % (imath::detail::clz(d) + 1);
+        u64 n = rng() >> (rng() % 64);
+        checkBoth<u64>(d, n);
+        u32 d32 = static_cast<u32>(d >> (rng() % 64)) | 1;
+        checkBoth<u32>(d32, static_cast<u32>(n));
+    }
+}
+
+TEST_CASE( "Rounding to multiples", "[roundUpToMultipleOf]" ) {
+    CHECK(imath::roundUpToMultipleOf(u32{5}, u32{1}) == 5);
+    CHECK(imath::roundUpToMultipleOf(u64{5}, u64{4}) == 8);
+    CHECK(imath::roundUpToMultipleOf(u64{8}, u64{4}) == 8);
+    CHECK(imath::roundDownToMultipleOf(u64{7}, u64{4}) == 4);
+    CHECK(imath::roundUpToMultipleOf(u64{5}, imath::Divider<u64>{1}) == 5);
+    CHECK(imath::roundUpToMultipleOf(u32{4097},
+                                     imath::Divider<u32>{4096}) == 8192);
+    CHECK(imath::roundDownToMultipleOf(u32{4097},
+                                       imath::Divider<u32, true>{7}) == 4095);
+}
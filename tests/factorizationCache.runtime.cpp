@@ -0,0 +1,121 @@
+#include "imath.h"
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+
+using u64 = uint64_t;
+
+namespace {
+
+bool sameFactorization(const imath::FactorizationResultU64& a,
+                       const imath::FactorizationResultU64& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].prime != b[i].prime || a[i].power != b[i].power) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+TEST_CASE( "Factorization cache hits and misses", "[FactorizationCache]" ) {
+    imath::FactorizationCache cache{100};
+    CHECK(cache.capacity() == 128);
+
+    imath::FactorizationResultU64 result{};
+    CHECK(!cache.lookup(u64{1000003} * 1000033, result));
+    CHECK(cache.misses() == 1);
+
+    const u64 numbers[] = {
+        u64{1000003} * 1000033,
+        u64{1} << 63,
+        18446744073709551557u,                          // prime
+        u64{2} * 3 * 5 * 7 * 11 * 13 * 17,              // 7 factors
+        u64{2} * 3 * 5 * 7 * 11 * 13 * 17 * 19,         // 8, not cached
+        u64{4294967291} * 4294967291,
+    };
+    for (u64 n : numbers) {
+        INFO("n = " << n);
+        CHECK(sameFactorization(cache.factorize(n), imath::factorize(n)));
+    }
+    u64 misses = cache.misses();
+    CHECK(cache.hits() == 0);
+
+    for (u64 n : numbers) {
+        INFO("n = " << n);
+        CHECK(sameFactorization(cache.factorize(n), imath::factorize(n)));
+    }
+    CHECK(cache.hits() == 5);
+    CHECK(cache.misses() == misses + 1);
+
+    // 1 is never stored
+    CHECK(cache.factorize(1).size() == 0);
+    CHECK(!cache.lookup(1, result));
+}
+
+TEST_CASE( "Factorization cache eviction", "[FactorizationCache]" ) {
+    imath::FactorizationCache cache{16};
+    std::mt19937_64 rng{};
+    std::vector<u64> numbers(1000);
+    for (u64& n : numbers) {
+        n = rng() >> 24;
+    }
+    for (int pass = 0; pass < 3; ++pass) {
+        for (u64 n : numbers) {
+            INFO("n = " << n);
+            CHECK(sameFactorization(cache.factorize(n), imath::factorize(n)));
+        }
+    }
+    CHECK(cache.hits() + cache.misses() == 3000);
+
+    // A hot value survives the eviction of cold ones
+    u64 hot = numbers[0];
+    cache.factorize(hot);
+    for (u64 n : numbers) {
+        cache.factorize(n);
+        imath::FactorizationResultU64 result{};
+        CHECK(cache.lookup(hot, result));
+    }
+}
+
+TEST_CASE( "Factorization cache in many threads", "[FactorizationCache]" ) {
+    imath::FactorizationCache cache{64};
+    std::vector<u64> numbers(256);
+    std::mt19937_64 rng{};
+    for (u64& n : numbers) {
+        n = rng() >> 20;
+    }
+    std::vector<imath::FactorizationResultU64> expected;
+    for (u64 n : numbers) {
+        expected.push_back(imath::factorize(n));
+    }
+
+    std::vector<int> errors(4);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < errors.size(); ++t) {
+        threads.emplace_back([&, t] {
+            std::mt19937_64 thread_rng{t};
+            for (int i = 0; i < 20000; ++i) {
+                size_t idx = thread_rng() % 16 == 0 ? thread_rng() % 256
+                                                    : thread_rng() % 8;
+                if (!sameFactorization(cache.factorize(numbers[idx]),
+                                       expected[idx])) {
+                    ++errors[t];
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (int error_count : errors) {
+        CHECK(error_count == 0);
+    }
+    CHECK(cache.hits() + cache.misses() == 80000);
+    CHECK(cache.hits() > 40000);
+}
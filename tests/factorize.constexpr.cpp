@@ -0,0 +1,48 @@
+#include <cstdint>
+
+#include "imath.h"
+#include "catch2/catch_test_macros.hpp"
+
+uint32_t constexpr operator"" _u32(unsigned long long n) {
+    return static_cast<uint32_t>(n);
+}
+uint64_t constexpr operator"" _u64(unsigned long long n) {
+    return static_cast<uint64_t>(n);
+}
+
+TEST_CASE( "Correct constexpr factorization", "[factorizeconstexpr]" ) {
+    STATIC_REQUIRE(imath::factorize(1_u32).size() == 0);
+    STATIC_REQUIRE(imath::factorize(4294967291_u32).back().prime == 4294967291);
+    STATIC_REQUIRE(imath::factorize(4294311817_u32)[0].prime == 65519);
+    STATIC_REQUIRE(imath::factorize(4294311817_u32)[1].prime == 65543);
+    STATIC_REQUIRE(imath::factorize(9223372036854775808_u64)[0].power == 63);
+    STATIC_REQUIRE(imath::factorize(18446744073709551557_u64).size() == 1);
+    STATIC_REQUIRE(imath::factorize(1000036000099_u64)[0].prime == 1000003);
+    STATIC_REQUIRE(imath::factorize(1000036000099_u64)[1].prime == 1000033);
+    // The product of the two largest 32-bit primes
+    STATIC_REQUIRE(imath::factorize(18446743979220271189_u64)[0].prime ==
+                   4294967279);
+    STATIC_REQUIRE(imath::factorize(18446743979220271189_u64)[1].prime ==
+                   4294967291);
+}
+
+TEST_CASE( "Correct constexpr factorization with budget",
+           "[factorizeconstexpr]" ) {
+    STATIC_REQUIRE(
+        imath::factorizeWithBudget(18446743979220271189_u64, 0).cofactor(0)
+            .value == 18446743979220271189_u64);
+    STATIC_REQUIRE(
+        imath::factorizeWithBudget(18446743979220271189_u64, 1000000)
+            .complete());
+}
+
+TEST_CASE( "Correct constexpr factorization table", "[factorizeconstexpr]" ) {
+    constexpr imath::FactorTable<65536> table{};
+    STATIC_REQUIRE(table.factorize(65535).size() == 4);
+    STATIC_REQUIRE(table.factorize(65535)[3].prime == 257);
+    STATIC_REQUIRE(table.factorize(65521).size() == 1);
+    STATIC_REQUIRE(table.factorize(59049)[0].power == 10);
+    STATIC_REQUIRE(table.smallestPrimeFactor(64507) == 251);
+    STATIC_REQUIRE(table.isPrime(65521));
+    STATIC_REQUIRE(!table.isPrime(65517));
+}
@@ -0,0 +1,250 @@
+#include "imath.h"
+#include "catch2/catch_test_macros.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+
+using u32 = uint32_t;
+using u64 = uint64_t;
+
+namespace {
+
+// All the factors are primes in increasing order, and multiply to n
+template <typename Result, typename T>
+bool isFactorization(const Result& result, T n) {
+    T product = 1;
+    T previous = 1;
+    for (const auto& factor : result) {
+        if (factor.prime <= previous || !imath::isPrime(factor.prime)) {
+            return false;
+        }
+        previous = factor.prime;
+        for (size_t i = 0; i < factor.power; ++i) product *= factor.prime;
+    }
+    return product == n;
+}
+
+}  // namespace
+
+TEST_CASE( "Factorization of small-prime numbers", "[factorize]" ) {
+    CHECK(imath::factorize(u32{1}).size() == 0);
+    CHECK(imath::factorize(u64{1}).size() == 0);
+
+    auto result = imath::factorize(u32{998244352});  // 2^23 * 7 * 17
+    REQUIRE(result.size() == 3);
+    CHECK((result[0].prime == 2 && result[0].power == 23));
+    CHECK((result[1].prime == 7 && result[1].power == 1));
+    CHECK((result[2].prime == 17 && result[2].power == 1));
+
+    auto result64 = imath::factorize(u64{1} << 63);
+    REQUIRE(result64.size() == 1);
+    CHECK((result64[0].prime == 2 && result64[0].power == 63));
+}
+
+TEST_CASE( "Factorization randomized", "[factorize]" ) {
+    std::mt19937_64 rng{};
+    for (int test_case = 0; test_case < 10000; ++test_case) {
+        u64 n = (rng() >> (rng() % 64)) | 2;
+        INFO("n = " << n);
+        CHECK(isFactorization(imath::factorize(n), n));
+        u32 n32 = static_cast<u32>(n);
+        CHECK(isFactorization(imath::factorize(n32), n32));
+    }
+}
+
+TEST_CASE( "Factorization of prime powers", "[factorize]" ) {
+    auto result = imath::factorize(u64{1000003} * 1000003 * 1000003);
+    REQUIRE(result.size() == 1);
+    CHECK((result[0].prime == 1000003 && result[0].power == 3));
+
+    result = imath::factorize(u64{4294967291} * 4294967291);
+    REQUIRE(result.size() == 1);
+    CHECK((result[0].prime == 4294967291 && result[0].power == 2));
+
+    // 59^9 * 61, rho finds only powers of 59 in it
+    result = imath::factorize(imath::pow(u64{59}, u64{9}) * 61);
+    REQUIRE(result.size() == 2);
+    CHECK((result[0].prime == 59 && result[0].power == 9));
+    CHECK((result[1].prime == 61 && result[1].power == 1));
+
+    auto result32 = imath::factorize(u32{65521} * 65521);
+    REQUIRE(result32.size() == 1);
+    CHECK((result32[0].prime == 65521 && result32[0].power == 2));
+
+    std::mt19937_64 rng{};
+    for (int test_case = 0; test_case < 1000; ++test_case) {
+        uint32_t k = static_cast<uint32_t>(rng() % 6 + 2);
+        u64 max_root = imath::iroot(UINT64_MAX, k);
+        u64 p = imath::nextPrimeAfter(rng() % (max_root / 2) + 53);
+        u64 q = imath::nextPrimeAfter(rng() % 1000 + 53);
+        u64 n = imath::pow(p, u64{k - 1});
+        if (n <= UINT64_MAX / q) n *= q;
+        INFO("p = " << p << ", k = " << k << ", q = " << q);
+        CHECK(isFactorization(imath::factorize(n), n));
+    }
+}
+
+TEST_CASE( "Trial division table", "[factorize]" ) {
+    u64 previous = 2;
+    for (const auto& divisor : imath::detail::kTrialDivisorsU64) {
+        INFO("p = " << divisor.prime);
+        CHECK(divisor.prime > previous);
+        CHECK(imath::isPrime(divisor.prime));
+        CHECK(imath::nextPrimeAfter(previous) == divisor.prime);
+        CHECK(divisor.prime * divisor.inverse == 1);
+        CHECK(divisor.limit == UINT64_MAX / divisor.prime);
+        previous = divisor.prime;
+    }
+    for (const auto& divisor : imath::detail::kTrialDivisorsU32) {
+        CHECK(static_cast<u32>(divisor.prime * divisor.inverse) == 1);
+    }
+}
+
+TEST_CASE( "Factorization of numbers with small factors", "[factorize]" ) {
+    std::mt19937_64 rng{};
+    for (int test_case = 0; test_case < 10000; ++test_case) {
+        u64 n = 1;
+        while (true) {
+            u64 p = imath::nextPrimeAfter(rng() % 20000);
+            if (n > UINT64_MAX / p) break;
+            n *= p;
+        }
+        INFO("n = " << n);
+        CHECK(isFactorization(imath::factorize(n), n));
+        u32 n32 = static_cast<u32>(n >> (rng() % 32)) | 1;
+        CHECK(isFactorization(imath::factorize(n32), n32));
+    }
+}
+
+TEST_CASE( "Factorization of semiprimes", "[factorize]" ) {
+    std::mt19937_64 rng{};
+    for (int test_case = 0; test_case < 200; ++test_case) {
+        u64 p = imath::nextPrimeAfter(rng() >> 33);
+        u64 q = imath::nextPrimeAfter(rng() >> 33);
+        u64 n = p * q;
+        INFO("n = " << n);
+        auto result = imath::factorize(n);
+        CHECK(isFactorization(result, n));
+        CHECK(result.size() == (p == q ? 1u : 2u));
+    }
+    // Squares of 32-bit primes are found by the perfect power test,
+    // products of the largest ones by rho
+    CHECK(isFactorization(imath::factorize(u64{4294967291} * 4294967279),
+                          u64{4294967291} * 4294967279));
+    CHECK(isFactorization(imath::factorize(u32{65521} * 65519),
+                          u32{65521} * 65519));
+}
+
+TEST_CASE( "Factorization table", "[factorize]" ) {
+    static constexpr imath::FactorTable<100000> table{};
+    CHECK(table.size() == 100000);
+    CHECK(sizeof(imath::FactorTable<65536>) == 32768);
+    CHECK(sizeof(imath::FactorTable<65537>) == 65536);
+    CHECK(table.factorize(0).size() == 0);
+    CHECK(table.factorize(1).size() == 0);
+    CHECK(!table.isPrime(0));
+    CHECK(!table.isPrime(1));
+    for (u32 n = 2; n < 100000; ++n) {
+        INFO("n = " << n);
+        auto expected = imath::factorize(n);
+        auto result = table.factorize(n);
+        REQUIRE(result.size() == expected.size());
+        for (size_t i = 0; i < result.size(); ++i) {
+            CHECK(result[i].prime == expected[i].prime);
+            CHECK(result[i].power == expected[i].power);
+        }
+        CHECK(table.isPrime(n) == imath::isPrime(n));
+        CHECK(table.smallestPrimeFactor(n) == expected[0].prime);
+    }
+}
+
+TEST_CASE( "Factorization with a budget", "[factorize]" ) {
+    u64 p = 2147483647;
+    u64 q = 1000000007;
+    u64 n = 8 * 101 * q;
+    auto partial = imath::factorizeWithBudget(n, 1000000);
+    CHECK(partial.complete());
+    CHECK(isFactorization(partial.primes(), n));
+
+    n = p * q;
+    partial = imath::factorizeWithBudget(n, 0);
+    CHECK(!partial.complete());
+    CHECK(partial.primes().size() == 0);
+    REQUIRE(partial.cofactorCount() == 1);
+    CHECK((partial.cofactor(0).value == n && partial.cofactor(0).power == 1));
+
+    // Trial division and the perfect power test need no rho steps
+    n = 8 * 101 * u64{65537} * 65537 * 65537;
+    partial = imath::factorizeWithBudget(n, 0);
+    CHECK(partial.complete());
+    CHECK(isFactorization(partial.primes(), n));
+
+    n = u64{10007} * 10009;
+    partial = imath::factorizeWithBudget(n * n, 0);
+    REQUIRE(partial.cofactorCount() == 1);
+    CHECK((partial.cofactor(0).value == n && partial.cofactor(0).power == 2));
+
+    // Whatever the budget, primes and cofactors multiply to n
+    std::mt19937_64 rng{};
+    for (int test_case = 0; test_case < 2000; ++test_case) {
+        n = rng() | 1;
+        u64 budget = rng() % 4096;
+        INFO("n = " << n << ", budget = " << budget);
+        partial = imath::factorizeWithBudget(n, budget);
+        u64 product = 1;
+        u64 previous = 1;
+        for (const auto& factor : partial.primes()) {
+            CHECK(factor.prime > previous);
+            CHECK(imath::isPrime(factor.prime));
+            previous = factor.prime;
+            for (size_t i = 0; i < factor.power; ++i) product *= factor.prime;
+        }
+        for (size_t k = 0; k < partial.cofactorCount(); ++k) {
+            const auto& cofactor = partial.cofactor(k);
+            CHECK(!imath::isPrime(cofactor.value));
+            for (size_t i = 0; i < cofactor.power; ++i) {
+                product *= cofactor.value;
+            }
+        }
+        CHECK(product == n);
+        if (partial.complete()) {
+            CHECK(isFactorization(partial.primes(), n));
+        }
+    }
+}
+
+TEST_CASE( "Factorization with a deadline", "[factorize]" ) {
+    u64 n = u64{4294967291} * 4294967279;
+    auto now = std::chrono::steady_clock::now();
+    auto partial = imath::factorizeWithDeadline(n, now);
+    REQUIRE(partial.cofactorCount() == 1);
+    CHECK(partial.cofactor(0).value == n);
+
+    partial = imath::factorizeWithDeadline(n, now + std::chrono::hours(1));
+    CHECK(partial.complete());
+    CHECK(isFactorization(partial.primes(), n));
+}
+
+#if IMATHLIB_ENABLE_THREADS
+TEST_CASE( "Factorization with rho walks raced on threads", "[factorize]" ) {
+    std::mt19937_64 rng{};
+    for (int test_case = 0; test_case < 50; ++test_case) {
+        u64 p = imath::nextPrimeAfter(rng() >> 33);
+        u64 q = imath::nextPrimeAfter(rng() >> 33);
+        u64 n = p * q;
+        INFO("n = " << n);
+        CHECK(isFactorization(imath::factorizeParallel(n, 4), n));
+    }
+    for (int test_case = 0; test_case < 200; ++test_case) {
+        u64 n = (rng() >> (rng() % 64)) | 1;
+        INFO("n = " << n);
+        CHECK(isFactorization(imath::factorizeParallel(n, 3), n));
+        CHECK(isFactorization(imath::factorizeParallel(n, 1), n));
+    }
+    u64 n = u64{4294967291} * 4294967279;
+    CHECK(isFactorization(imath::factorizeParallel(n), n));
+    CHECK(isFactorization(imath::factorizeParallel(n, 4), n));
+    CHECK(imath::factorizeParallel(u64{1}).size() == 0);
+}
+#endif
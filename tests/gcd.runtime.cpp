@@ -0,0 +1,120 @@
+#include "imath.h"
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using u32 = uint32_t;
+using u64 = uint64_t;
+
+namespace {
+
+// Numbers with a lot of common factors and some zeroes
+template <typename T, typename Rng>
+T genNumber(Rng& rng) {
+    switch (rng() % 8) {
+        case 0: return 0;
+        case 1: return static_cast<T>(rng());
+        case 2: return static_cast<T>(rng() >> (rng() % (sizeof(T) * 8)));
+        default: break;
+    }
+    T result = 1;
+    for (int i = 0; i < 6; ++i) {
+        T factor = static_cast<T>(imath::kSmallPrimes[rng() % 8]);
+        if (result <= static_cast<T>(-1) / factor) result *= factor;
+    }
+    return result << (rng() % 8);
+}
+
+}  // namespace
+
+TEST_CASE( "GCD u32 randomized", "[gcd32]" ) {
+    std::mt19937 rng{};
+    for (int test_case = 0; test_case < 100000; ++test_case) {
+        u32 a = genNumber<u32>(rng);
+        u32 b = genNumber<u32>(rng);
+        INFO("a = " << a << ", b = " << b);
+        CHECK(imath::gcd(a, b) == imath::detail::gcdModuloRecursive(a, b));
+    }
+}
+
+TEST_CASE( "GCD u64 randomized", "[gcd64]" ) {
+    std::mt19937_64 rng{};
+    for (int test_case = 0; test_case < 100000; ++test_case) {
+        u64 a = genNumber<u64>(rng);
+        u64 b = genNumber<u64>(rng);
+        INFO("a = " << a << ", b = " << b);
+        CHECK(imath::gcd(a, b) == imath::detail::gcdModuloRecursive(a, b));
+    }
+}
+
+TEST_CASE( "Elementwise GCD u32", "[gcdArray32]" ) {
+    std::mt19937 rng{};
+    std::vector<u32> a(10007);
+    std::vector<u32> b(a.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        a[i] = genNumber<u32>(rng);
+        b[i] = genNumber<u32>(rng);
+    }
+    a[0] = UINT32_MAX;
+    b[1] = UINT32_MAX;
+    std::vector<u32> out(a.size());
+    imath::gcd(a.data(), b.data(), a.size(), out.data());
+    for (size_t i = 0; i < a.size(); ++i) {
+        INFO("a = " << a[i] << ", b = " << b[i]);
+        CHECK(out[i] == imath::detail::gcdModuloRecursive(a[i], b[i]));
+    }
+}
+
+TEST_CASE( "Elementwise GCD u64", "[gcdArray64]" ) {
+    std::mt19937_64 rng{};
+    std::vector<u64> a(10007);
+    std::vector<u64> b(a.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        a[i] = genNumber<u64>(rng);
+        b[i] = genNumber<u64>(rng);
+    }
+    a[0] = UINT64_MAX;
+    b[1] = UINT64_MAX;
+    a[2] = 1ull << 63;
+    b[2] = 1ull << 62;
+    std::vector<u64> out(a.size());
+    imath::gcd(a.data(), b.data(), a.size(), out.data());
+    for (size_t i = 0; i < a.size(); ++i) {
+        INFO("a = " << a[i] << ", b = " << b[i]);
+        CHECK(out[i] == imath::detail::gcdModuloRecursive(a[i], b[i]));
+    }
+}
+
+TEST_CASE( "GCD of arrays", "[gcdReduce]" ) {
+    const u64 numbers[] = {720720, 360360 * 7, 0, 5040 * 11};
+    CHECK(imath::gcdReduce(numbers, 0) == 0);
+    CHECK(imath::gcdReduce(numbers, 1) == 720720);
+    CHECK(imath::gcdReduce(numbers, 3) == 360360);
+    CHECK(imath::gcdReduce(numbers, 4) == 27720);
+
+    const u32 coprime[] = {6, 10, 15, 0};
+    CHECK(imath::gcdReduce(coprime, 4) == 1);
+}
+
+TEST_CASE( "LCM of arrays", "[lcmReduce]" ) {
+    const u64 numbers[] = {2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13};
+    CHECK(imath::lcmReduce(numbers, 0) == 1);
+    CHECK(imath::lcmReduce(numbers, 12) == 360360);
+
+    const u32 numbers32[] = {65536, 65535, 3, 2};
+    CHECK(imath::lcmReduce(numbers32, 2) == 4294901760u);
+    CHECK(imath::lcmReduce(numbers32, 3) == 4294901760u);
+    CHECK(imath::lcmReduce(numbers32, 4) == 4294901760u);
+
+    const u64 overflow[] = {4294967291u, 4294967279u, 4294967231u};
+    CHECK(imath::lcmReduce(overflow, 2) == u64{4294967291u} * 4294967279u);
+    CHECK(imath::lcmReduce(overflow, 3) == 0);
+
+    const u32 overflow32[] = {65536, 65537};
+    CHECK(imath::lcmReduce(overflow32, 2) == 0);
+
+    const u64 with_zero[] = {5, 0, 7};
+    CHECK(imath::lcmReduce(with_zero, 3) == 0);
+}
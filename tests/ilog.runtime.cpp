@@ -0,0 +1,82 @@
+#include "imath.h"
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+using u32 = uint32_t;
+using u64 = uint64_t;
+
+namespace {
+
+// floor(log_base(n)) by repeated division
+uint32_t ilogNaive(u64 n, u64 base) {
+    uint32_t result = 0;
+    while (n >= base) {
+        n /= base;
+        ++result;
+    }
+    return result;
+}
+
+}  // namespace
+
+TEST_CASE( "Integer binary logarithm", "[ilog2]" ) {
+    CHECK(imath::ilog2(u32{0}) == 0);
+    CHECK(imath::ilog2(u64{0}) == 0);
+    for (uint32_t i = 0; i < 64; ++i) {
+        u64 power = u64{1} << i;
+        CHECK(imath::ilog2(power) == i);
+        CHECK(imath::ilog2(power | (power - 1)) == i);
+        if (i < 32) {
+            CHECK(imath::ilog2(static_cast<u32>(power)) == i);
+        }
+    }
+}
+
+TEST_CASE( "Integer decimal logarithm", "[ilog10]" ) {
+    CHECK(imath::ilog10(u64{0}) == 0);
+    CHECK(imath::ilog10(u32{0}) == 0);
+    u64 power = 1;
+    for (uint32_t i = 0; i < 20; ++i) {
+        INFO("i = " << i);
+        CHECK(imath::ilog10(power) == i);
+        if (i > 0) CHECK(imath::ilog10(power - 1) == i - 1);
+        if (power <= UINT32_MAX) {
+            CHECK(imath::ilog10(static_cast<u32>(power)) == i);
+            CHECK(imath::ilog10(static_cast<u32>(power - 1)) ==
+                  (i > 0 ? i - 1 : 0));
+        }
+        if (i < 19) power *= 10;
+    }
+    CHECK(imath::ilog10(UINT64_MAX) == 19);
+    CHECK(imath::ilog10(UINT32_MAX) == 9);
+
+    std::mt19937_64 rng{};
+    for (int test_case = 0; test_case < 100000; ++test_case) {
+        u64 n = (rng() >> (rng() % 64)) | 1;
+        INFO("n = " << n);
+        CHECK(imath::ilog10(n) + 1 == std::to_string(n).size());
+    }
+}
+
+TEST_CASE( "Integer logarithm base b", "[ilog]" ) {
+    CHECK(imath::ilog(u64{1}, u64{2}) == 0);
+    CHECK(imath::ilog(UINT64_MAX, u64{2}) == 63);
+    CHECK(imath::ilog(UINT64_MAX, u64{3}) == 40);
+    CHECK(imath::ilog(u64{12157665459056928801u}, u64{3}) == 40);
+    CHECK(imath::ilog(u64{12157665459056928800u}, u64{3}) == 39);
+    CHECK(imath::ilog(UINT64_MAX, UINT64_MAX) == 1);
+    CHECK(imath::ilog(UINT64_MAX - 1, UINT64_MAX) == 0);
+    CHECK(imath::ilog(u32{1000}, u32{10}) == 3);
+    CHECK(imath::ilog(UINT32_MAX, u32{16}) == 7);
+
+    std::mt19937_64 rng{};
+    for (int test_case = 0; test_case < 100000; ++test_case) {
+        u64 n = (rng() >> (rng() % 64)) | 1;
+        u64 base = (rng() >> (rng() % 64)) | 2;
+        INFO("n = " << n << ", base = " << base);
+        CHECK(imath::ilog(n, base) == ilogNaive(n, base));
+    }
+}
@@ -0,0 +1,53 @@
+#include <cstdint>
+
+#include "imath.h"
+#include "catch2/catch_test_macros.hpp"
+
+uint32_t constexpr operator"" _u32(unsigned long long n) {
+    return static_cast<uint32_t>(n);
+}
+uint64_t constexpr operator"" _u64(unsigned long long n) {
+    return static_cast<uint64_t>(n);
+}
+
+TEST_CASE( "Correct constexpr integer square root", "[isqrtconstexpr]" ) {
+    STATIC_REQUIRE(imath::isqrt(0_u32) == 0);
+    STATIC_REQUIRE(imath::isqrt(1_u32) == 1);
+    STATIC_REQUIRE(imath::isqrt(4294967295_u32) == 65535);
+    STATIC_REQUIRE(imath::isqrt(1000000014000000048_u64) == 1000000006);
+    STATIC_REQUIRE(imath::isqrt(1000000014000000049_u64) == 1000000007);
+    STATIC_REQUIRE(imath::isqrt(18446744073709551615_u64) == 4294967295);
+}
+
+TEST_CASE( "Correct constexpr integer roots", "[irootconstexpr]" ) {
+    STATIC_REQUIRE(imath::icbrt(26_u32) == 2);
+    STATIC_REQUIRE(imath::icbrt(27_u32) == 3);
+    STATIC_REQUIRE(imath::icbrt(18446724184312856125_u64) == 2642245);
+    STATIC_REQUIRE(imath::icbrt(18446744073709551615_u64) == 2642245);
+    STATIC_REQUIRE(imath::iroot(1024_u64, 10) == 2);
+    STATIC_REQUIRE(imath::iroot(1023_u64, 10) == 1);
+    STATIC_REQUIRE(imath::iroot(18446744073709551615_u64, 64) == 1);
+    STATIC_REQUIRE(imath::iroot(18446744073709551615_u64, 5) == 7131);
+}
+
+TEST_CASE( "Correct constexpr perfect square test", "[isPerfectSquareconstexpr]" ) {
+    STATIC_REQUIRE(imath::isPerfectSquare(1000000014000000049_u64));
+    STATIC_REQUIRE(!imath::isPerfectSquare(1000000014000000048_u64));
+    STATIC_REQUIRE(imath::isPerfectSquare(18446744065119617025_u64));
+    STATIC_REQUIRE(imath::isPerfectSquare(4294836225_u32));
+}
+
+TEST_CASE( "Correct constexpr integer logarithms", "[ilogconstexpr]" ) {
+    STATIC_REQUIRE(imath::ilog2(1_u32) == 0);
+    STATIC_REQUIRE(imath::ilog2(18446744073709551615_u64) == 63);
+    STATIC_REQUIRE(imath::ilog10(999999999_u32) == 8);
+    STATIC_REQUIRE(imath::ilog10(10000000000000000000_u64) == 19);
+    STATIC_REQUIRE(imath::ilog(18446744073709551615_u64, 3_u64) == 40);
+}
+
+TEST_CASE( "Correct constexpr perfect power test", "[isPerfectPowerconstexpr]" ) {
+    STATIC_REQUIRE(imath::isPerfectPower(2176782336_u64).root == 6);
+    STATIC_REQUIRE(imath::isPerfectPower(2176782336_u64).exponent == 12);
+    STATIC_REQUIRE(!imath::isPerfectPower(18446744073709551615_u64));
+    STATIC_REQUIRE(imath::isPerfectPower(3486784401_u32).exponent == 20);
+}
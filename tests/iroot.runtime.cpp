@@ -0,0 +1,151 @@
+#include "imath.h"
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstdint>
+#include <random>
+
+using u64 = uint64_t;
+
+namespace {
+
+// true if r^k > n, without overflow
+bool powGreaterThan(u64 r, uint32_t k, u64 n) {
+    u64 result = 1;
+    for (uint32_t i = 0; i < k; ++i) {
+        if (r != 0 && result > n / r) return true;
+        result *= r;
+    }
+    return result > n;
+}
+
+// r is the k-th root of n if r^k <= n < (r+1)^k
+bool isFloorRoot(u64 r, u64 n, uint32_t k) {
+    return !powGreaterThan(r, k, n) && powGreaterThan(r + 1, k, n);
+}
+
+}  // namespace
+
+TEST_CASE( "Integer square root small numbers", "[isqrt]" ) {
+    for (uint32_t n = 0; n < 100000; ++n) {
+        INFO("n = " << n);
+        CHECK(isFloorRoot(imath::isqrt(n), n, 2));
+        CHECK(imath::detail::isqrtNewton(n) == imath::isqrt(n));
+    }
+}
+
+TEST_CASE( "Integer square root around squares u64", "[isqrt]" ) {
+    std::mt19937_64 rng{};
+    for (int test_case = 0; test_case < 100000; ++test_case) {
+        u64 r = rng() >> 32;
+        if (test_case == 0) r = UINT32_MAX;
+        u64 n = r * r;
+        INFO("r = " << r);
+        CHECK(imath::isqrt(n) == r);
+        CHECK(imath::detail::isqrtNewton(n) == r);
+        if (n > 0) {
+            CHECK(imath::isqrt(n - 1) == r - 1);
+            CHECK(imath::detail::isqrtNewton(n - 1) == r - 1);
+        }
+        if (r < UINT32_MAX) {
+            CHECK(imath::isqrt(n + 2 * r) == r);
+            CHECK(imath::detail::isqrtNewton(n + 2 * r) == r);
+        }
+    }
+    CHECK(imath::isqrt(UINT64_MAX) == UINT32_MAX);
+    CHECK(imath::detail::isqrtNewton(UINT64_MAX) == UINT32_MAX);
+}
+
+TEST_CASE( "Integer cube root around cubes u64", "[icbrt]" ) {
+    for (u64 r = 0; r <= 2642245; r += (r < 10000 ? 1 : 97)) {
+        u64 n = r * r * r;
+        INFO("r = " << r);
+        CHECK(imath::icbrt(n) == r);
+        CHECK(imath::detail::irootNewton(n, 3) == r);
+        if (n > 0) {
+            CHECK(imath::icbrt(n - 1) == r - 1);
+            CHECK(imath::detail::irootNewton(n - 1, 3) == r - 1);
+        }
+    }
+    CHECK(imath::icbrt(UINT64_MAX) == 2642245);
+    CHECK(imath::detail::irootNewton(UINT64_MAX, 3) == 2642245);
+}
+
+TEST_CASE( "Integer k-th root randomized", "[iroot]" ) {
+    std::mt19937_64 rng{};
+    for (int test_case = 0; test_case < 10000; ++test_case) {
+        u64 n = rng() >> (rng() % 64);
+        for (uint32_t k = 1; k <= 66; ++k) {
+            INFO("n = " << n << ", k = " << k);
+            CHECK(isFloorRoot(imath::iroot(n, k), n, k));
+        }
+    }
+    CHECK(imath::iroot(UINT64_MAX, 1) == UINT64_MAX);
+    for (uint32_t k = 2; k <= 66; ++k) {
+        INFO("k = " << k);
+        CHECK(isFloorRoot(imath::iroot(UINT64_MAX, k), UINT64_MAX, k));
+        CHECK(imath::iroot(uint32_t{UINT32_MAX}, k) ==
+              imath::iroot(uint64_t{UINT32_MAX}, k));
+    }
+}
+
+TEST_CASE( "Perfect power detection", "[isPerfectPower]" ) {
+    const u64 not_powers[] = {0, 1, 2, 3, 6, 10, 12, 72, 1000000007,
+                              (u64{1} << 32) - 1, UINT64_MAX};
+    for (u64 n : not_powers) {
+        INFO("n = " << n);
+        auto result = imath::isPerfectPower(n);
+        CHECK(!result);
+        CHECK(result.root == n);
+        CHECK(result.exponent == 1);
+    }
+
+    auto result = imath::isPerfectPower(u64{1} << 63);
+    CHECK((result.root == 2 && result.exponent == 63));
+    result = imath::isPerfectPower(u64{1} << 60);
+    CHECK((result.root == 2 && result.exponent == 60));
+    result = imath::isPerfectPower(u64{4294967291} * 4294967291);
+    CHECK((result.root == 4294967291 && result.exponent == 2));
+    result = imath::isPerfectPower(u64{12157665459056928801u});  // 3^40
+    CHECK((result.root == 3 && result.exponent == 40));
+    result = imath::isPerfectPower(u64{2176782336});  // 6^12
+    CHECK((result.root == 6 && result.exponent == 12));
+    for (u64 root : {2, 3, 5, 6, 7, 10, 11, 12, 13}) {
+        uint32_t exponent = imath::ilog(UINT64_MAX, root);
+        INFO("root = " << root << ", exponent = " << exponent);
+        result = imath::isPerfectPower(imath::pow(root, u64{exponent}));
+        CHECK((result.root == root && result.exponent == exponent));
+        result = imath::isPerfectPower(imath::pow(root, u64{17}));
+        CHECK((result.root == root && result.exponent == 17));
+    }
+    result = imath::isPerfectPower(u64{1} << 62 | u64{1} << 31);  // not even
+    CHECK(!result);
+
+    auto result32 = imath::isPerfectPower(uint32_t{3486784401u});  // 3^20
+    CHECK((result32.root == 3 && result32.exponent == 20));
+    CHECK(!imath::isPerfectPower(UINT32_MAX));
+}
+
+TEST_CASE( "Perfect power detection randomized", "[isPerfectPower]" ) {
+    std::mt19937_64 rng{};
+    for (int test_case = 0; test_case < 10000; ++test_case) {
+        uint32_t k = static_cast<uint32_t>(rng() % 20 + 2);
+        u64 max_root = imath::iroot(UINT64_MAX, k);
+        u64 root = rng() % (max_root - 1) + 2;
+        u64 n = imath::pow(root, u64{k});
+        INFO("root = " << root << ", k = " << k);
+        auto result = imath::isPerfectPower(n);
+        REQUIRE(result);
+        CHECK(imath::pow(result.root, u64{result.exponent}) == n);
+        CHECK(result.exponent % k == 0);
+        // the root itself is not a perfect power
+        CHECK(!imath::isPerfectPower(result.root));
+
+        u64 neighbour = n + 1;
+        auto other = imath::isPerfectPower(neighbour);
+        if (other) {
+            CHECK(imath::pow(other.root, u64{other.exponent}) == neighbour);
+        } else {
+            CHECK(other.root == neighbour);
+        }
+    }
+}
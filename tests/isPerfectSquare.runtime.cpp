@@ -0,0 +1,81 @@
+#include "imath.h"
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+using u64 = uint64_t;
+
+TEST_CASE( "Perfect square small numbers u32", "[isPerfectSquare32]" ) {
+    uint32_t next_root = 0;
+    for (uint32_t n = 0; n < 1000000; ++n) {
+        bool is_square = (next_root * next_root == n);
+        if (is_square) ++next_root;
+        INFO("n = " << n);
+        CHECK(imath::isPerfectSquare(n) == is_square);
+        CHECK(imath::isPerfectSquare(u64{n}) == is_square);
+    }
+}
+
+#if IMATHLIB_HAS_CONSTEXPR_INTR
+TEST_CASE( "Perfect square in constant expressions", "[isPerfectSquareconstexpr]" ) {
+    STATIC_REQUIRE(imath::isPerfectSquare(uint32_t{4294836225u}));
+    STATIC_REQUIRE(!imath::isPerfectSquare(uint32_t{4294836224u}));
+    STATIC_REQUIRE(imath::isPerfectSquare(u64{1000000014000000049ull}));
+    STATIC_REQUIRE(!imath::isPerfectSquare(u64{1000000014000000048ull}));
+}
+#endif
+
+TEST_CASE( "Perfect square randomized u64", "[isPerfectSquare64]" ) {
+    std::mt19937_64 rng{};
+    for (int test_case = 0; test_case < 100000; ++test_case) {
+        u64 r = rng() >> 32;
+        if (test_case == 0) r = UINT32_MAX;
+        u64 n = r * r;
+        INFO("r = " << r);
+        CHECK(imath::isPerfectSquare(n));
+        if (r < UINT32_MAX) {
+            CHECK(imath::isPerfectSquare(n + 2 * r + 1));
+        }
+        if (r > 1) {
+            CHECK_FALSE(imath::isPerfectSquare(n - 1));
+            CHECK_FALSE(imath::isPerfectSquare(n + 1));
+        }
+    }
+}
+
+TEST_CASE( "Residue filters accept all squares", "[isSquareModSmallOdd]" ) {
+    // 63 * 65 * 11 * 31
+    constexpr u64 kModulus = 1396395;
+    for (u64 r = 0; r < kModulus; ++r) {
+        INFO("r = " << r);
+        CHECK(imath::detail::isSquareModSmallOdd(r * r));
+        u64 n = r * r + (1ull << 60);
+        CHECK(imath::detail::isSquareModSmallOdd(n) ==
+              imath::detail::isSquareModSmallOdd(n % kModulus));
+    }
+}
+
+TEST_CASE( "Perfect square batch", "[isPerfectSquareBatch]" ) {
+    std::mt19937_64 rng{};
+    std::vector<u64> numbers;
+    for (int i = 0; i < 100003; ++i) {
+        u64 r = rng() >> (32 + rng() % 32);
+        switch (rng() % 4) {
+            case 0: numbers.push_back(r * r); break;
+            case 1: numbers.push_back(r * r + 1); break;
+            case 2: numbers.push_back(rng()); break;
+            default: numbers.push_back(rng() >> (rng() % 64)); break;
+        }
+    }
+    numbers.push_back(0);
+    numbers.push_back(UINT64_MAX);
+    std::unique_ptr<bool[]> results{new bool[numbers.size()]};
+    imath::isPerfectSquare(numbers.data(), numbers.size(), results.get());
+    for (size_t i = 0; i < numbers.size(); ++i) {
+        INFO("n = " << numbers[i]);
+        CHECK(results[i] == imath::isPerfectSquare(numbers[i]));
+    }
+}
@@ -358,3 +358,11 @@ TEST_CASE( "Correct constexpr prime test for all problematic cases",
 }
 
 #endif
+
+TEST_CASE( "Correct constexpr prime array", "[PrimeArrayconstexpr]" ) {
+    constexpr imath::PrimeArray<1000> primes;
+    STATIC_REQUIRE(primes[0] == 2);
+    STATIC_REQUIRE(primes[3] == 7);
+    STATIC_REQUIRE(primes[168] == 1009);
+    STATIC_REQUIRE(primes.back() == 7919);
+}
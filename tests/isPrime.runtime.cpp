@@ -1,5 +1,7 @@
 #include <cstdint>
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include "imath.h"
 #include "catch2/catch_test_macros.hpp"
@@ -366,3 +368,42 @@ TEST_CASE( "Primes used in XXHASH algorithm u64", "[isPrime64]") {
     CHECK(imath::isPrime(XXPRIME64_4) == true);
     CHECK(imath::isPrime(XXPRIME64_5) == true);
 }
+
+TEST_CASE( "Prime array", "[PrimeArray]" ) {
+    static constexpr imath::PrimeArray<1> one;
+    CHECK(one[0] == 2);
+    static constexpr imath::PrimeArray<3, uint8_t> wheel;
+    CHECK(wheel.back() == 5);
+    static constexpr imath::PrimeArray<1000, uint16_t> primes;
+    CHECK(primes.size() == 1000);
+    uint32_t n = 0;
+    for (uint16_t p : primes) {
+        n = imath::nextPrimeAfter(n);
+        REQUIRE(p == n);
+    }
+
+    // Not constexpr, to keep the compilation fast
+    auto many = std::make_unique<imath::PrimeArray<100000>>();
+    CHECK(many->back() == 1299709);
+    n = 0;
+    for (uint32_t p : *many) {
+        n = imath::nextPrimeAfter(n);
+        REQUIRE(p == n);
+    }
+}
+
+TEST_CASE( "Upper bound of the n-th prime", "[PrimeArray]" ) {
+    std::vector<bool> composite(2000000);
+    uint64_t count = 0;
+    for (uint64_t n = 2; n < composite.size(); ++n) {
+        if (composite[n]) continue;
+        ++count;
+        INFO("n = " << count << ", p_n = " << n);
+        REQUIRE(n <= imath::detail::nthPrimeUpperBound(count));
+        // Close enough to size the sieve
+        CHECK(imath::detail::nthPrimeUpperBound(count) < n + n / 4 + 10);
+        for (uint64_t m = n * n; m < composite.size(); m += n) {
+            composite[m] = true;
+        }
+    }
+}
@@ -0,0 +1,104 @@
+#include "imath.h"
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using u64 = uint64_t;
+
+namespace {
+
+constexpr u64 kMersenne61 = (u64{1} << 61) - 1;
+
+const u64 kEdgeCases[] = {0, 1, 2, kMersenne61 - 1, kMersenne61,
+                          kMersenne61 + 1, u64{1} << 63, UINT64_MAX - 1,
+                          UINT64_MAX};
+
+// The general path of mulmod, with no special forms
+u64 mulmodByDivision(u64 a, u64 b, u64 mod) {
+    imath::detail::u128 x = imath::detail::mul64x64(a, b);
+    x.hi %= mod;
+    if (x.hi == 0) {
+        return x.lo % mod;
+    }
+    return imath::detail::mod128by64Fallback(x, mod);
+}
+
+}  // namespace
+
+TEST_CASE( "Multiplication modulo 2^61 - 1", "[mulmodMersenne61]" ) {
+    for (u64 a : kEdgeCases) {
+        for (u64 b : kEdgeCases) {
+            INFO("a = " << a << ", b = " << b);
+            CHECK(imath::mulmodMersenne61(a, b) ==
+                  mulmodByDivision(a, b, kMersenne61));
+            CHECK(imath::mulmod(a, b, kMersenne61) ==
+                  imath::mulmodMersenne61(a, b));
+        }
+    }
+
+    std::mt19937_64 rng{};
+    for (int test_case = 0; test_case < 100000; ++test_case) {
+        u64 a = rng() >> (rng() % 64);
+        u64 b = rng();
+        INFO("a = " << a << ", b = " << b);
+        CHECK(imath::mulmodMersenne61(a, b) ==
+              mulmodByDivision(a, b, kMersenne61));
+    }
+
+    std::vector<u64> numbers(1000);
+    for (u64& number : numbers) {
+        number = rng();
+    }
+    u64 b = rng();
+    std::vector<u64> out(numbers.size());
+    imath::mulmodMersenne61(numbers.data(), numbers.size(), b, out.data());
+    for (size_t i = 0; i < numbers.size(); ++i) {
+        CHECK(out[i] == mulmodByDivision(numbers[i], b, kMersenne61));
+    }
+    imath::mulmodMersenne61(numbers.data(), numbers.size(), b,
+                            numbers.data());
+    CHECK(numbers == out);
+}
+
+TEST_CASE( "Multiplication modulo 2^64 - c", "[PseudoMersenne]" ) {
+    STATIC_REQUIRE(imath::PseudoMersenne<59>::modulo() == UINT64_MAX - 58);
+    STATIC_REQUIRE(imath::PseudoMersenne<59>::reduce(UINT64_MAX) == 58);
+    STATIC_REQUIRE(imath::PseudoMersenne<59>::reduce(58) == 58);
+    for (u64 a : kEdgeCases) {
+        for (u64 b : kEdgeCases) {
+            INFO("a = " << a << ", b = " << b);
+            CHECK(imath::PseudoMersenne<1>::mul(a, b) ==
+                  mulmodByDivision(a, b, UINT64_MAX));
+            CHECK(imath::PseudoMersenne<59>::mul(a, b) ==
+                  mulmodByDivision(a, b, UINT64_MAX - 58));
+            CHECK(imath::PseudoMersenne<0xffffffff>::mul(a, b) ==
+                  mulmodByDivision(a, b, 0 - u64{0xffffffff}));
+        }
+    }
+
+    std::mt19937_64 rng{};
+    for (int test_case = 0; test_case < 100000; ++test_case) {
+        u64 c = (rng() >> (rng() % 32 + 32)) | 1;
+        u64 a = rng() >> (rng() % 64);
+        u64 b = rng();
+        INFO("a = " << a << ", b = " << b << ", c = " << c);
+        CHECK(imath::detail::mulmodPseudoMersenne(a, b, c) ==
+              mulmodByDivision(a, b, 0 - c));
+        CHECK(imath::PseudoMersenne<59>::mul(a, b) ==
+              mulmodByDivision(a, b, UINT64_MAX - 58));
+    }
+
+    std::vector<u64> numbers(1000);
+    for (u64& number : numbers) {
+        number = rng();
+    }
+    u64 b = rng();
+    std::vector<u64> out(numbers.size());
+    imath::PseudoMersenne<59>::mul(numbers.data(), numbers.size(), b,
+                                   out.data());
+    for (size_t i = 0; i < numbers.size(); ++i) {
+        CHECK(out[i] == mulmodByDivision(numbers[i], b, UINT64_MAX - 58));
+    }
+}
@@ -72,3 +72,82 @@ TEST_CASE( "Modulo 128 bit by 64 bit Fallback randomized empty lower bits", "[mo
         REQUIRE(builtin_result == fallback_result);
     }
 }
+
+TEST_CASE( "Modulo 128 bit by 64 bit randomized", "[mod128by64]" ) {
+    std::minstd_rand rng{};
+    auto gen_u64 = [&rng]() { return (u64{rng()} << 32) | rng(); };
+    for (int test_case = 0; test_case < 1024; ++test_case) {
+        u64 a1 = gen_u64();
+        u64 a2 = gen_u64();
+        u64 b = gen_u64() >> (rng() % 32);
+        a1 %= b;
+        if (a1 == 0) a1 = 1;
+        u128s a = {a1, a2};
+        INFO("a1 = " << a1 << ", a2 = " << a2 << ", b = " << b);
+
+        u64 builtin_result = mod128by64builtin(a, b);
+        u64 imath_result = imath::detail::mod128by64(a, b);
+        u64 native_result = imath::detail::mod128by64Native(a, b);
+
+        CHECK(builtin_result == imath_result);
+        CHECK(builtin_result == native_result);
+    }
+}
+
+TEST_CASE( "Modulo 128 bit by 64 bit Reciprocal randomized", "[mod128by64r]" ) {
+    std::minstd_rand rng{};
+    auto gen_u64 = [&rng]() { return (u64{rng()} << 32) | rng(); };
+    for (int test_case = 0; test_case < 4096; ++test_case) {
+        u64 a1 = gen_u64();
+        u64 a2 = gen_u64();
+        u64 b = gen_u64() >> (rng() % 64);
+        if (b == 0) b = 1;
+        a1 %= b;
+        u128s a = {a1, a2};
+        INFO("a1 = " << a1 << ", a2 = " << a2 << ", b = " << b);
+
+        u64 builtin_result = mod128by64builtin(a, b);
+        u64 reciprocal_result = imath::detail::mod128by64Reciprocal(a, b);
+
+        CHECK(builtin_result == reciprocal_result);
+    }
+}
+
+TEST_CASE( "Modulo 128 bit by 64 bit Reciprocal edge cases", "[mod128by64r]" ) {
+    constexpr u64 max = static_cast<u64>(-1);
+    const u64 mods[] = {1, 2, 3, 0xffffffff, 0x100000000, 1ull << 63,
+                        (1ull << 63) + 1, max - 1, max};
+    for (u64 b : mods) {
+        const u128s cases[] = {{0, 0}, {0, max}, {b - 1, 0}, {b - 1, max}};
+        for (u128s a : cases) {
+            INFO("a1 = " << a.hi << ", a2 = " << a.lo << ", b = " << b);
+            CHECK(mod128by64builtin(a, b) ==
+                  imath::detail::mod128by64Reciprocal(a, b));
+        }
+    }
+}
+
+TEST_CASE( "Reciprocal of normalized 64 bit divisor", "[reciprocal64]" ) {
+    std::minstd_rand rng{};
+    auto gen_u64 = [&rng]() { return (u64{rng()} << 32) | rng(); };
+    for (int test_case = 0; test_case < 4096; ++test_case) {
+        u64 d = gen_u64() | (1ull << 63);
+        if (test_case == 0) d = 1ull << 63;
+        if (test_case == 1) d = static_cast<u64>(-1);
+        INFO("d = " << d);
+
+        // floor((2^128 - 1) / d) - 2^64 = floor(((2^64 - 1 - d) * 2^64 + 2^64 - 1) / d)
+        u128s n = {~d, static_cast<u64>(-1)};
+        u64 expected = 0;
+#if defined(__SIZEOF_INT128__)
+        __uint128_t p{n.hi};
+        p <<= 64;
+        p |= n.lo;
+        expected = static_cast<u64>(p / d);
+#elif defined(_M_X64)
+        u64 reminder;
+        expected = _udiv128(n.hi, n.lo, d, &reminder);
+#endif
+        CHECK(imath::detail::reciprocal64(d) == expected);
+    }
+}
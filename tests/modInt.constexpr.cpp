@@ -0,0 +1,26 @@
+#include <cstdint>
+
+#include "imath.h"
+#include "catch2/catch_test_macros.hpp"
+
+TEST_CASE( "Correct constexpr ModInt", "[ModIntconstexpr]" ) {
+    using Ntt = imath::ModInt<998244353>;
+    constexpr Ntt three{3};
+    STATIC_REQUIRE(three.pow(998244352).value() == 1);
+    STATIC_REQUIRE((three * three.inverse()).value() == 1);
+    STATIC_REQUIRE((-three).value() == 998244350);
+
+    using Mersenne = imath::ModInt<(uint64_t{1} << 61) - 1>;
+    constexpr Mersenne big{uint64_t{1} << 60};
+    STATIC_REQUIRE((big * big).value() == uint64_t{1} << 59);
+    STATIC_REQUIRE((big + big).value() == 1);
+
+    using PseudoMersenne = imath::ModInt<UINT64_MAX - 58>;
+    constexpr PseudoMersenne max{UINT64_MAX};
+    STATIC_REQUIRE((max * max).value() == 58 * 58);
+
+    using Even = imath::ModInt<(uint64_t{1} << 62) + 2>;
+    constexpr Even power{uint64_t{1} << 62};
+    STATIC_REQUIRE((power * power).value() == 4);
+    STATIC_REQUIRE((power - Even{5}).value() == (uint64_t{1} << 62) - 5);
+}
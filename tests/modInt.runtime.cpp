@@ -0,0 +1,89 @@
+#include "imath.h"
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstdint>
+#include <random>
+
+using u64 = uint64_t;
+
+namespace {
+
+// Compares every operation with mulmod and powmod on random inputs
+template <u64 M>
+void checkModInt() {
+    using Mod = imath::ModInt<M>;
+    STATIC_REQUIRE(Mod::modulo() == M);
+    std::mt19937_64 rng{M};
+    const u64 edge_cases[] = {0, 1, 2, M - 1, M, M + 1, UINT64_MAX};
+    for (int test_case = 0; test_case < 20000; ++test_case) {
+        u64 a = test_case < 49 ? edge_cases[test_case % 7] : rng();
+        u64 b = test_case < 49 ? edge_cases[test_case / 7] : rng();
+        u64 a_mod = a % M;
+        u64 b_mod = b % M;
+        Mod x{a};
+        Mod y{b};
+        INFO("a = " << a << ", b = " << b << ", M = " << M);
+        REQUIRE(x.value() == a_mod);
+        CHECK((x * y).value() == imath::mulmod(a_mod, b_mod, M));
+        CHECK((x + y).value() ==
+              (a_mod >= M - b_mod ? a_mod - (M - b_mod) : a_mod + b_mod));
+        CHECK((x - y).value() ==
+              (a_mod >= b_mod ? a_mod - b_mod : a_mod + (M - b_mod)));
+        CHECK((x - y + y) == x);
+        CHECK((-x + x) == Mod{});
+        if (test_case % 16 == 0) {
+            CHECK(x.pow(b).value() == imath::powmod(a_mod, b, M) % M);
+        }
+    }
+}
+
+}  // namespace
+
+TEST_CASE( "ModInt with power of two moduli", "[ModInt]" ) {
+    checkModInt<1>();
+    checkModInt<2>();
+    checkModInt<u64{1} << 32>();
+    checkModInt<u64{1} << 63>();
+}
+
+TEST_CASE( "ModInt with Mersenne and pseudo-Mersenne moduli", "[ModInt]" ) {
+    checkModInt<3>();
+    checkModInt<(u64{1} << 31) - 1>();
+    checkModInt<(u64{1} << 61) - 1>();
+    checkModInt<(u64{1} << 63) - 1>();
+    checkModInt<UINT64_MAX>();
+    checkModInt<UINT64_MAX - 1>();
+    checkModInt<UINT64_MAX - 58>();
+    checkModInt<UINT64_MAX - 4294967295ull>();
+}
+
+TEST_CASE( "ModInt with odd moduli", "[ModInt]" ) {
+    checkModInt<998244353>();
+    checkModInt<1000000007>();
+    checkModInt<4294967291ull>();
+    checkModInt<(u64{1} << 32) + 15>();
+    checkModInt<(u64{1} << 62) + 135>();
+    checkModInt<UINT64_MAX - 4294967296ull>();
+}
+
+TEST_CASE( "ModInt with even moduli", "[ModInt]" ) {
+    checkModInt<6>();
+    checkModInt<1000000006>();
+    checkModInt<(u64{1} << 32) * 3>();
+    checkModInt<(u64{1} << 62) + 2>();
+    checkModInt<(u64{1} << 63) + 2>();
+    checkModInt<UINT64_MAX - 4294967297ull>();
+}
+
+TEST_CASE( "ModInt inverse", "[ModInt]" ) {
+    using Mod = imath::ModInt<998244353>;
+    for (u64 n = 1; n < 1000; ++n) {
+        CHECK((Mod{n} * Mod{n}.inverse()).value() == 1);
+    }
+    CHECK(Mod{}.inverse() == Mod{});
+
+    using Even = imath::ModInt<(u64{1} << 62) + 2>;
+    CHECK((Even{5} * Even{5}.inverse()).value() == 1);
+    CHECK(Even{3}.inverse().value() == 0);
+    CHECK(Even{4}.inverse().value() == 0);
+}
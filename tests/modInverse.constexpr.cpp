@@ -0,0 +1,31 @@
+#include <cstdint>
+
+#include "imath.h"
+#include "catch2/catch_test_macros.hpp"
+
+uint32_t constexpr operator"" _u32(unsigned long long n) {
+    return static_cast<uint32_t>(n);
+}
+uint64_t constexpr operator"" _u64(unsigned long long n) {
+    return static_cast<uint64_t>(n);
+}
+
+TEST_CASE( "Correct constexpr extended GCD", "[extendedGcdconstexpr]" ) {
+    constexpr auto r = imath::extendedGcd(240_u64, 46_u64);
+    STATIC_REQUIRE(r.gcd == 2);
+    STATIC_REQUIRE(r.x == -9);
+    STATIC_REQUIRE(r.y == 47);
+    constexpr auto r32 = imath::extendedGcd(4294967295_u32, 4294967294_u32);
+    STATIC_REQUIRE(r32.gcd == 1);
+    STATIC_REQUIRE(r32.x == 1);
+    STATIC_REQUIRE(r32.y == -1);
+}
+
+TEST_CASE( "Correct constexpr modular inverse", "[modInverseconstexpr]" ) {
+    STATIC_REQUIRE(imath::modInverse(3_u32, 7_u32) == 5);
+    STATIC_REQUIRE(imath::modInverse(3_u32, 8_u32) == 3);
+    STATIC_REQUIRE(imath::modInverse(4_u32, 8_u32) == 0);
+    STATIC_REQUIRE(imath::modInverse(2_u64, 18446744073709551615_u64) ==
+                   9223372036854775808_u64);
+    STATIC_REQUIRE(imath::modInverse(10_u64, 1000000007_u64) == 700000005);
+}
@@ -0,0 +1,131 @@
+#include "imath.h"
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using u32 = uint32_t;
+using u64 = uint64_t;
+
+namespace {
+
+// a * x + b * y == gcd, checked modulo 2^64
+bool isBezout(u64 a, u64 b, imath::ExtendedGcdU64 r) {
+    return a * static_cast<u64>(r.x) + b * static_cast<u64>(r.y) == r.gcd;
+}
+
+u64 absolute(int64_t x) {
+    return x < 0 ? u64{0} - static_cast<u64>(x) : static_cast<u64>(x);
+}
+
+}  // namespace
+
+TEST_CASE( "Extended GCD edge cases", "[extendedGcd]" ) {
+    auto r = imath::extendedGcd(u64{0}, u64{0});
+    CHECK(r.gcd == 0);
+    r = imath::extendedGcd(u64{0}, u64{5});
+    CHECK((r.gcd == 5 && r.x == 0 && r.y == 1));
+    r = imath::extendedGcd(u64{5}, u64{0});
+    CHECK((r.gcd == 5 && r.x == 1 && r.y == 0));
+    r = imath::extendedGcd(u64{240}, u64{46});
+    CHECK((r.gcd == 2 && r.x == -9 && r.y == 47));
+    r = imath::extendedGcd(UINT64_MAX, UINT64_MAX - 1);
+    CHECK((r.gcd == 1 && r.x == 1 && r.y == -1));
+    r = imath::extendedGcd(u64{1}, UINT64_MAX);
+    CHECK((r.gcd == 1 && r.x == 1 && r.y == 0));
+
+    auto r32 = imath::extendedGcd(UINT32_MAX, UINT32_MAX - 1);
+    CHECK((r32.gcd == 1 && r32.x == 1 && r32.y == -1));
+}
+
+TEST_CASE( "Extended GCD randomized", "[extendedGcd]" ) {
+    std::mt19937_64 rng{};
+    for (int test_case = 0; test_case < 100000; ++test_case) {
+        u64 common = rng() >> (rng() % 64);
+        u64 a = (rng() >> (rng() % 64)) * common;
+        u64 b = (rng() >> (rng() % 64)) * common;
+        INFO("a = " << a << ", b = " << b);
+        auto r = imath::extendedGcd(a, b);
+        CHECK(r.gcd == imath::detail::gcdModuloRecursive(a, b));
+        CHECK(isBezout(a, b, r));
+        if (r.gcd != 0) {
+            CHECK(absolute(r.x) <= imath::detail::max(u64{1}, b / r.gcd / 2));
+            CHECK(absolute(r.y) <= imath::detail::max(u64{1}, a / r.gcd / 2));
+        }
+
+        u32 a32 = static_cast<u32>(a);
+        u32 b32 = static_cast<u32>(b);
+        auto r32 = imath::extendedGcd(a32, b32);
+        CHECK(r32.gcd == imath::gcd(a32, b32));
+        CHECK(a32 * static_cast<u32>(r32.x) + b32 * static_cast<u32>(r32.y)
+              == r32.gcd);
+    }
+}
+
+TEST_CASE( "Modular inverse", "[modInverse]" ) {
+    CHECK(imath::modInverse(u64{3}, u64{7}) == 5);
+    CHECK(imath::modInverse(u64{10}, u64{7}) == 5);
+    CHECK(imath::modInverse(u64{3}, u64{8}) == 3);
+    CHECK(imath::modInverse(u64{4}, u64{8}) == 0);
+    CHECK(imath::modInverse(u64{0}, u64{7}) == 0);
+    CHECK(imath::modInverse(u64{5}, u64{1}) == 0);
+    CHECK(imath::modInverse(UINT64_MAX - 1, UINT64_MAX) == UINT64_MAX - 1);
+    CHECK(imath::modInverse(u64{2}, UINT64_MAX) == (UINT64_MAX >> 1) + 1);
+    CHECK(imath::modInverse(UINT32_MAX - 1, UINT32_MAX) == UINT32_MAX - 1);
+}
+
+TEST_CASE( "Modular inverse randomized", "[modInverse]" ) {
+    std::mt19937_64 rng{};
+    for (int test_case = 0; test_case < 100000; ++test_case) {
+        u64 mod = (rng() >> (rng() % 64)) | 1;
+        mod <<= (test_case % 4 == 0) ? rng() % 8 : 0;
+        u64 n = rng();
+        INFO("n = " << n << ", mod = " << mod);
+        u64 inverse = imath::modInverse(n, mod);
+        if (imath::gcd(n, mod) == 1) {
+            CHECK(inverse < mod);
+            CHECK(imath::mulmod(n, inverse, mod) == 1 % mod);
+        } else {
+            CHECK(inverse == 0);
+        }
+
+        u32 mod32 = static_cast<u32>(mod) | 1;
+        u32 n32 = static_cast<u32>(n);
+        u32 inverse32 = imath::modInverse(n32, mod32);
+        if (imath::gcd(n32, mod32) == 1) {
+            CHECK(imath::mulmod(n32, inverse32, mod32) == 1 % mod32);
+        } else {
+            CHECK(inverse32 == 0);
+        }
+    }
+}
+
+TEST_CASE( "Batched modular inverse", "[modInverseArray]" ) {
+    std::mt19937_64 rng{};
+    const u64 mods[] = {1000000007, 18446744073709551557u, 1ull << 40,
+                        3ull * 5 * 7 * 11 * 13 * 1000003};
+    for (u64 mod : mods) {
+        std::vector<u64> numbers(1001);
+        for (auto& n : numbers) n = rng() | 1;
+        std::vector<u64> out(numbers.size());
+        imath::modInverse(numbers.data(), numbers.size(), mod, out.data());
+        for (size_t i = 0; i < numbers.size(); ++i) {
+            INFO("n = " << numbers[i] << ", mod = " << mod);
+            CHECK(out[i] == imath::modInverse(numbers[i], mod));
+        }
+    }
+
+    std::vector<u32> numbers32(1001);
+    for (auto& n : numbers32) n = static_cast<u32>(rng() % 1000);
+    std::vector<u32> out32(numbers32.size());
+    imath::modInverse(numbers32.data(), numbers32.size(), 997u, out32.data());
+    for (size_t i = 0; i < numbers32.size(); ++i) {
+        INFO("n = " << numbers32[i]);
+        CHECK(out32[i] == imath::modInverse(numbers32[i], 997u));
+    }
+
+    u64 single = 3;
+    imath::modInverse(&single, 1, u64{7}, &single);
+    CHECK(single == 5);
+}
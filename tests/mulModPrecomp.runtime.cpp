@@ -0,0 +1,72 @@
+#include "imath.h"
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using u64 = uint64_t;
+
+TEST_CASE( "Shoup mulmod edge cases", "[MulModPrecomp]" ) {
+    const u64 max_mod = (u64{1} << 63) - 1;
+    const u64 inputs[] = {0, 1, 2, max_mod - 1, max_mod, max_mod + 1,
+                          UINT64_MAX - 1, UINT64_MAX};
+    const u64 moduli[] = {1, 2, 3, 1ull << 32, (1ull << 32) + 1,
+                          max_mod - 24, max_mod};
+    for (u64 mod : moduli) {
+        for (u64 b : inputs) {
+            imath::MulModPrecomp precomp{b, mod};
+            CHECK(precomp.multiplier() == b % mod);
+            CHECK(precomp.modulo() == mod);
+            for (u64 a : inputs) {
+                INFO("a = " << a << ", b = " << b << ", mod = " << mod);
+                CHECK(precomp.mul(a) == imath::mulmod(a, b, mod));
+                u64 lazy = precomp.mulLazy(a);
+                CHECK(lazy < 2 * mod);
+                CHECK(lazy % mod == precomp.mul(a));
+            }
+        }
+    }
+}
+
+TEST_CASE( "Shoup mulmod randomized", "[MulModPrecomp]" ) {
+    std::mt19937_64 rng{};
+    for (int test_case = 0; test_case < 100000; ++test_case) {
+        u64 mod = (rng() >> (rng() % 64 + 1)) | 1;
+        u64 b = rng();
+        u64 a = rng() >> (rng() % 64);
+        INFO("a = " << a << ", b = " << b << ", mod = " << mod);
+        CHECK(imath::MulModPrecomp{b, mod}.mul(a) ==
+              imath::mulmod(a, b, mod));
+    }
+}
+
+TEST_CASE( "Batched mulmod by a constant", "[MulModPrecomp]" ) {
+    std::mt19937_64 rng{};
+    std::vector<u64> numbers(1000);
+    for (u64& number : numbers) {
+        number = rng();
+    }
+    const u64 moduli[] = {1, 1000000007, (1ull << 62) + 135, UINT64_MAX - 58};
+    for (u64 mod : moduli) {
+        u64 b = rng();
+        std::vector<u64> out(numbers.size());
+        imath::mulmod(numbers.data(), numbers.size(), b, mod, out.data());
+        for (size_t i = 0; i < numbers.size(); ++i) {
+            CHECK(out[i] == imath::mulmod(numbers[i], b, mod));
+        }
+
+        // in place
+        std::vector<u64> in_place = numbers;
+        imath::mulmod(in_place.data(), in_place.size(), b, mod,
+                      in_place.data());
+        CHECK(in_place == out);
+    }
+
+    imath::MulModPrecomp precomp{3, 7};
+    u64 small[] = {0, 1, 2, 3, 4, 5, 6, 7};
+    imath::mulmod(small, 8, precomp, small);
+    CHECK(small[0] == 0);
+    CHECK(small[3] == 2);
+    CHECK(small[7] == 0);
+}
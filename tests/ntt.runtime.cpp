@@ -0,0 +1,128 @@
+#include "imath.h"
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using u32 = uint32_t;
+using u64 = uint64_t;
+
+namespace {
+
+size_t bitReverse(size_t n, size_t size) {
+    size_t result = 0;
+    for (size_t bit = 1; bit < size; bit *= 2) {
+        result = (result << 1) | ((n & bit) ? 1 : 0);
+    }
+    return result;
+}
+
+template <typename T>
+std::vector<T> naiveConvolution(const std::vector<T>& a,
+                                const std::vector<T>& b, T mod) {
+    std::vector<T> result(a.size() + b.size() - 1);
+    for (size_t i = 0; i < a.size(); ++i) {
+        for (size_t j = 0; j < b.size(); ++j) {
+            T product = imath::mulmod(a[i], b[j], mod);
+            result[i + j] = static_cast<T>((result[i + j] + product) % mod);
+        }
+    }
+    return result;
+}
+
+template <typename T, typename Rng>
+std::vector<T> randomVector(size_t size, T mod, Rng& rng) {
+    std::vector<T> result(size);
+    for (auto& x : result) x = static_cast<T>(rng() % mod);
+    return result;
+}
+
+// Covers scalar and vectorized butterflies and cache-blocked stages
+template <typename T>
+void checkNtt(T mod, size_t max_size) {
+    std::mt19937_64 rng{};
+    imath::Ntt<T> ntt(mod, max_size);
+    for (size_t size = 1; size <= max_size; size *= 2) {
+        INFO("mod = " << mod << ", size = " << size);
+        auto data = randomVector<T>(size, mod, rng);
+        auto transformed = data;
+        ntt.forward(transformed.data(), size);
+        ntt.inverse(transformed.data(), size);
+        CHECK(transformed == data);
+
+        size_t a_size = size / 2 + 1;
+        size_t b_size = size - a_size + 1;
+        auto a = randomVector<T>(a_size, mod, rng);
+        auto b = randomVector<T>(b_size, mod, rng);
+        std::vector<T> out(a_size + b_size - 1);
+        ntt.convolve(a.data(), a_size, b.data(), b_size, out.data());
+        CHECK(out == naiveConvolution(a, b, mod));
+    }
+}
+
+}  // namespace
+
+TEST_CASE( "NTT primes", "[nttPrime]" ) {
+    CHECK(imath::nttPrime(u32{1000000000}, 23) == 998244353);
+    CHECK(imath::nttPrime(u32{998244353}, 23) == 897581057);
+    CHECK(imath::nttPrime(u32{1} << 31, 24) == 2130706433);
+    CHECK(imath::nttPrime(u32{100}, 7) == 0);
+    CHECK(imath::nttPrime(u64{1} << 62, 32) == 4611685941117976577ull);
+    CHECK(imath::nttPrime(u64{1} << 63, 50) == 9198602238904238081ull);
+    CHECK(imath::nttPrime(u64{1} << 40, 40) == 0);
+    for (u32 log_size = 10; log_size < 28; ++log_size) {
+        u32 p = imath::nttPrime(u32{1} << 31, log_size);
+        INFO("log_size = " << log_size);
+        CHECK(imath::isPrime(p));
+        CHECK((p - 1) % (u32{1} << log_size) == 0);
+    }
+}
+
+TEST_CASE( "NTT is DFT in bit-reversed order", "[ntt]" ) {
+    const u32 mod = 998244353;
+    const size_t size = 64;
+    imath::Ntt<u32> ntt(mod, 1 << 10);
+    CHECK(ntt.primitiveRoot() == 3);
+    std::vector<u32> data(size);
+    data[1] = 1;
+    ntt.forward(data.data(), size);
+    u32 w = imath::powmod(3u, (mod - 1) / u32{size}, mod);
+    for (size_t i = 0; i < size; ++i) {
+        u32 power = static_cast<u32>(bitReverse(i, size));
+        CHECK(data[i] == imath::powmod(w, power, mod));
+    }
+}
+
+TEST_CASE( "NTT modulo 32-bit primes", "[ntt]" ) {
+    checkNtt(u32{998244353}, 1 << 13);
+    checkNtt(u32{2130706433}, 1 << 13);
+    checkNtt(u32{257}, 1 << 8);
+}
+
+TEST_CASE( "NTT modulo 64-bit primes", "[ntt]" ) {
+    checkNtt(u64{4179340454199820289ull}, 1 << 13);
+    checkNtt(u64{998244353}, 1 << 10);
+}
+
+TEST_CASE( "NTT convolution of large integers", "[ntt]" ) {
+    // 999...9 * 999...9 = 99...9800...01, in decimal digits (little-endian)
+    const size_t digits = 1000;
+    std::vector<u32> nines(digits, 9);
+    imath::Ntt<u32> ntt(998244353, 1 << 11);
+    std::vector<u32> product(2 * digits - 1);
+    ntt.convolve(nines.data(), digits, nines.data(), digits, product.data());
+    std::vector<u32> result;
+    u64 carry = 0;
+    for (u32 x : product) {
+        carry += x;
+        result.push_back(static_cast<u32>(carry % 10));
+        carry /= 10;
+    }
+    for (; carry; carry /= 10) result.push_back(static_cast<u32>(carry % 10));
+    REQUIRE(result.size() == 2 * digits);
+    CHECK(result[0] == 1);
+    for (size_t i = 1; i < digits; ++i) CHECK(result[i] == 0);
+    CHECK(result[digits] == 8);
+    for (size_t i = digits + 1; i < 2 * digits; ++i) CHECK(result[i] == 9);
+}
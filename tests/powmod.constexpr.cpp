@@ -0,0 +1,33 @@
+#include <cstdint>
+
+#include "imath.h"
+#include "catch2/catch_test_macros.hpp"
+
+TEST_CASE( "Correct constexpr powmod", "[powmodconstexpr]" ) {
+    STATIC_REQUIRE(imath::powmod(3u, 998244352u, 998244353u) == 1);
+    STATIC_REQUIRE(imath::powmod<998244351>(3u, 998244353u) == 332748118);
+    STATIC_REQUIRE(imath::powmod(uint64_t{2}, uint64_t{64},
+                                 uint64_t{18446744073709551557ull}) == 59);
+    STATIC_REQUIRE(imath::powmod<64>(uint64_t{2},
+                                     uint64_t{18446744073709551557ull}) == 59);
+    STATIC_REQUIRE(imath::powmod<10>(uint64_t{2}, uint64_t{1000}) == 24);
+
+    STATIC_REQUIRE(imath::powmod2(2u, 10u, 3u, 5u, 1000u) == 832);
+    STATIC_REQUIRE(imath::powmod2(uint64_t{3}, uint64_t{998244352},
+                                  uint64_t{5}, uint64_t{998244352},
+                                  uint64_t{998244353}) == 1);
+}
+
+namespace {
+
+constexpr uint64_t sumOfPowers() {
+    uint64_t bases[] = {2, 3, 5, 7, 11};
+    imath::powmodMulti(bases, 5, 1000000006, 1000000007, bases);
+    return bases[0] + bases[1] + bases[2] + bases[3] + bases[4];
+}
+
+}  // namespace
+
+TEST_CASE( "Correct constexpr powmodMulti", "[powmodconstexpr]" ) {
+    STATIC_REQUIRE(sumOfPowers() == 5);
+}
@@ -0,0 +1,139 @@
+#include "imath.h"
+#include "catch2/catch_test_macros.hpp"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using u32 = uint32_t;
+using u64 = uint64_t;
+
+namespace {
+
+// Square and multiply with mulmod, left to right
+template <typename T>
+T powmodReference(T n, T pow, T mod) {
+    T result = 1 % mod;
+    for (int bit = 8 * static_cast<int>(sizeof(T)) - 1; bit >= 0; --bit) {
+        result = imath::mulmod(result, result, mod);
+        if ((pow >> bit) & 1) {
+            result = imath::mulmod(result, n % mod, mod);
+        }
+    }
+    return result;
+}
+
+template <u64 E>
+void checkFixedExponent(std::mt19937_64& rng) {
+    for (int i = 0; i < 200; ++i) {
+        u64 mod = rng() >> (i % 64);
+        mod += mod == 0;
+        u64 n = rng();
+        INFO("n = " << n << ", E = " << E << ", mod = " << mod);
+        CHECK(imath::powmod<E>(n, mod) == powmodReference(n, E, mod));
+        u32 mod32 = static_cast<u32>(mod >> 32) | 1u << (i % 32);
+        u32 n32 = static_cast<u32>(n);
+        CHECK(imath::powmod<E>(n32, mod32) ==
+              powmodReference(u64{n32}, E, u64{mod32}));
+    }
+}
+
+}  // namespace
+
+TEST_CASE( "powmod matches square and multiply", "[powmod]" ) {
+    std::mt19937_64 rng(49);
+    const u64 exponents[] = {0, 1, 2, 255, 256, 65537, UINT64_MAX};
+    for (int i = 0; i < 1000; ++i) {
+        // Odd and even moduli of every size, 1 included
+        u64 mod = rng() >> (i % 64);
+        mod += mod == 0;
+        u64 n = rng();
+        u64 pow = i < 7 ? exponents[i] : rng() >> (i % 64);
+        if (pow == 0 && mod == 1) {
+            // powmod(n, 0, 1) is 1, as it always was
+            CHECK(imath::powmod(n, pow, mod) == 1);
+            continue;
+        }
+        INFO("n = " << n << ", pow = " << pow << ", mod = " << mod);
+        CHECK(imath::powmod(n, pow, mod) == powmodReference(n, pow, mod));
+        u32 mod32 = static_cast<u32>(mod);
+        mod32 += mod32 <= 1;
+        u32 n32 = static_cast<u32>(n);
+        u32 pow32 = static_cast<u32>(pow);
+        CHECK(imath::powmod(n32, pow32, mod32) ==
+              powmodReference(n32, pow32, mod32));
+    }
+    CHECK(imath::powmod(u64{7}, UINT64_MAX, UINT64_MAX) ==
+          powmodReference(u64{7}, UINT64_MAX, UINT64_MAX));
+    CHECK(imath::powmod(u32{3}, 4294967290u, 4294967291u) == 1);
+}
+
+TEST_CASE( "powmod with a fixed exponent", "[powmod]" ) {
+    std::mt19937_64 rng(2049);
+    checkFixedExponent<0>(rng);
+    checkFixedExponent<1>(rng);
+    checkFixedExponent<3>(rng);
+    checkFixedExponent<65537>(rng);
+    checkFixedExponent<998244351>(rng);
+    checkFixedExponent<UINT64_MAX>(rng);
+
+    // Fermat's inverse modulo the NTT prime, and a 64-bit one
+    constexpr u32 kNttPrime = 998244353;
+    CHECK(imath::mulmod(imath::powmod<kNttPrime - 2>(12345u, kNttPrime),
+                        12345u, kNttPrime) == 1);
+    constexpr u64 kPrime = 18446744073709551557ull;
+    u64 inverse = imath::powmod<kPrime - 2>(u64{12345}, kPrime);
+    CHECK(imath::mulmod(inverse, u64{12345}, kPrime) == 1);
+}
+
+TEST_CASE( "powmodMulti matches powmod", "[powmodMulti]" ) {
+    std::mt19937_64 rng(50);
+    std::vector<u64> bases(11);
+    std::vector<u64> out(bases.size());
+    for (int i = 0; i < 500; ++i) {
+        u64 mod = rng() >> (i % 64);
+        mod += mod == 0;
+        u64 pow = rng() >> (i % 64);
+        for (u64& base : bases) {
+            base = rng();
+        }
+        size_t count = static_cast<size_t>(i) % (bases.size() + 1);
+        imath::powmodMulti(bases.data(), count, pow, mod, out.data());
+        for (size_t j = 0; j < count; ++j) {
+            INFO("base = " << bases[j] << ", pow = " << pow
+                           << ", mod = " << mod);
+            CHECK(out[j] == imath::powmod(bases[j], pow, mod));
+        }
+    }
+
+    // In place
+    bases = {2, 3, 5, 7, 11};
+    imath::powmodMulti(bases.data(), bases.size(), 1000000006, 1000000007,
+                       bases.data());
+    CHECK(bases == std::vector<u64>(5, 1));
+}
+
+TEST_CASE( "powmod2 matches two powmods", "[powmod2]" ) {
+    std::mt19937_64 rng(51);
+    for (int i = 0; i < 1000; ++i) {
+        u64 mod = rng() >> (i % 64);
+        mod += mod == 0;
+        u64 a = rng();
+        u64 b = rng();
+        u64 x = rng() >> (i % 64);
+        u64 y = rng() >> (i * 7 % 64);
+        INFO("a = " << a << ", x = " << x << ", b = " << b << ", y = " << y
+                    << ", mod = " << mod);
+        CHECK(imath::powmod2(a, x, b, y, mod) ==
+              imath::mulmod(powmodReference(a, x, mod),
+                            powmodReference(b, y, mod), mod));
+        u32 mod32 = static_cast<u32>(mod >> 32) | 1u << (i % 32);
+        u32 a32 = static_cast<u32>(a);
+        u32 b32 = static_cast<u32>(b);
+        u32 x32 = static_cast<u32>(x);
+        u32 y32 = static_cast<u32>(y);
+        CHECK(imath::powmod2(a32, x32, b32, y32, mod32) ==
+              imath::mulmod(powmodReference(a32, x32, mod32),
+                            powmodReference(b32, y32, mod32), mod32));
+    }
+}
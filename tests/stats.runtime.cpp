@@ -0,0 +1,75 @@
+// Built as a separate executable, as IMATHLIB_STATS changes the header
+#define IMATHLIB_STATS 1
+#define IMATHLIB_ENABLE_THREADS 1
+#include "imath.h"
+#include "catch2/catch_test_macros.hpp"
+
+#include <thread>
+
+TEST_CASE( "Stats are reset and count trial division", "[stats]" ) {
+    imath::resetStats();
+    imath::Stats stats = imath::statsSnapshot();
+    CHECK(stats.factorize_calls == 0);
+    CHECK(stats.sprp_rounds == 0);
+
+    // 3^2 * 5 * 7 * 8167, where 8167 is what is left once 97^2 > 8167
+    auto result = imath::factorize(uint64_t{3 * 3 * 5 * 7} * 8167);
+    CHECK(result.size() == 4);
+    stats = imath::statsSnapshot();
+    CHECK(stats.factorize_calls == 1);
+    CHECK(stats.trial_division_hits == 3);
+    CHECK(stats.rho_calls == 0);
+    CHECK(stats.isprime_calls == 0);
+}
+
+TEST_CASE( "Stats count rho and primality tests", "[stats]" ) {
+    imath::resetStats();
+    // 4294967291 * 4294967279, no small factors
+    uint64_t n = 18446743979220271189ull;
+    auto result = imath::factorize(n);
+    REQUIRE(result.size() == 2);
+    imath::Stats stats = imath::statsSnapshot();
+    CHECK(stats.factorize_calls == 1);
+    CHECK(stats.trial_division_hits == 0);
+    CHECK(stats.rho_calls >= 1);
+    CHECK(stats.rho_calls == stats.rho_retries + 1);
+    CHECK(stats.rho_iterations >= stats.gcd_calls);
+    CHECK(stats.gcd_calls >= 1);
+    CHECK(stats.max_composite_stack == 1);
+    // n, and then both of its prime factors
+    CHECK(stats.isprime_calls == 3);
+    CHECK(stats.sprp_rounds >= 3);
+    CHECK(stats.rho_ns > 0);
+
+    imath::resetStats();
+    CHECK(imath::isPrime(uint64_t{18446744073709551557ull}));
+    stats = imath::statsSnapshot();
+    CHECK(stats.isprime_calls == 1);
+    CHECK(stats.sprp_rounds == 5);
+    CHECK(stats.factorize_calls == 0);
+}
+
+TEST_CASE( "Stats are per thread", "[stats]" ) {
+    imath::resetStats();
+    imath::factorize(uint64_t{1000000007} * 998244353);
+    imath::Stats other{};
+    std::thread thread([&other] {
+        other = imath::statsSnapshot();
+        imath::factorize(uint64_t{12345});
+    });
+    thread.join();
+    CHECK(other.factorize_calls == 0);
+    CHECK(imath::statsSnapshot().factorize_calls == 1);
+}
+
+TEST_CASE( "Stats include the threads of factorizeParallel", "[stats]" ) {
+    imath::resetStats();
+    // 4294967291 * 4294967279, longer than the steps before the race
+    auto result = imath::factorizeParallel(18446743979220271189ull, 4);
+    REQUIRE(result.size() == 2);
+    imath::Stats stats = imath::statsSnapshot();
+    // The sequential walk, and at least one walk of each of the 4 lanes
+    CHECK(stats.rho_calls >= 5);
+    CHECK(stats.rho_iterations >= stats.gcd_calls);
+    CHECK(stats.factorize_calls == 1);
+}